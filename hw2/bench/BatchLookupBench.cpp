@@ -0,0 +1,53 @@
+// Per-key TreeSet::contains() against contains_batch() on a set much larger
+// than the last-level cache, where each lookup is a chain of cache misses.
+//
+//   g++ -std=c++17 -O2 -I hw2/lib hw2/bench/BatchLookupBench.cpp -o batch_lookup_bench
+#include "TreeSet.cpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 8'000'000;
+    size_t batch = argc > 2 ? std::stoul(argv[2]) : 1024;
+
+    std::vector<int64_t> values(n);
+    for (size_t i = 0; i < n; i++)
+        values[i] = static_cast<int64_t>(i) * 2;
+    auto set = TreeSet<int64_t>::from_sorted_range(values.begin(), values.end());
+    values.clear();
+    values.shrink_to_fit();
+
+    std::mt19937_64 rng(15);
+    std::vector<int64_t> probes(4'000'000);
+    for (int64_t &probe : probes)
+        probe = static_cast<int64_t>(rng() % (2 * n));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t single_hits = 0;
+    for (int64_t probe : probes)
+        single_hits += set.contains(probe);
+    double single = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    size_t batch_hits = 0;
+    std::vector<int64_t> chunk;
+    for (size_t i = 0; i < probes.size(); i += batch)
+    {
+        chunk.assign(probes.begin() + i, probes.begin() + std::min(probes.size(), i + batch));
+        for (bool hit : set.contains_batch(chunk))
+            batch_hits += hit;
+    }
+    double batched = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    if (single_hits != batch_hits)
+        std::printf("(hit counts differ: %zu vs %zu)\n", single_hits, batch_hits);
+    std::printf("%zu elements, %zu probes, batches of %zu\n", n, probes.size(), batch);
+    std::printf("contains()        %7.1f ns/lookup\n", single / probes.size());
+    std::printf("contains_batch()  %7.1f ns/lookup\n", batched / probes.size());
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Read throughput of a TreeMap behind one global mutex against
+// ConcurrentTreeMap, from 1 thread up to the number of hardware threads.
+//
+//   g++ -std=c++17 -O2 -pthread -I hw2/lib hw2/bench/ConcurrentReadBench.cpp -o concurrent_read_bench
+#include "ConcurrentTreeMap.cpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Lookup hits are stored here so the compiler cannot drop the lookups
+static volatile size_t sink;
+
+// Runs `threads` readers for a fixed time and returns lookups per second
+template <typename Lookup>
+double measure(unsigned threads, Lookup lookup)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> total{0};
+    std::atomic<size_t> hits_total{0};
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            std::mt19937 rng(t);
+            size_t done = 0;
+            size_t hits = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                for (int i = 0; i < 256; i++)
+                    hits += lookup(static_cast<int>(rng() % 1'000'000));
+                done += 256;
+            }
+            total += done;
+            hits_total += hits; });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    for (std::thread &worker : workers)
+        worker.join();
+    sink = sink + hits_total;
+    return total / 0.5;
+}
+
+int main()
+{
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 1'000'000; i++)
+        items.push_back({i, i});
+
+    TreeMap<int, int> plain(items);
+    std::mutex global;
+    ConcurrentTreeMap<int, int> concurrent(items);
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("threads  global-mutex Mops/s  ConcurrentTreeMap Mops/s\n");
+    // Doubling thread counts, ending on the hardware thread count
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        double locked = measure(threads, [&](int key)
+                                { std::lock_guard<std::mutex> lock(global); return plain.contains(key); });
+        double sharded = measure(threads, [&](int key)
+                                 { return concurrent.contains(key); });
+        std::printf("%7u  %19.2f  %24.2f\n", threads, locked / 1e6, sharded / 1e6);
+
+        if (threads == max_threads)
+            break;
+    }
+    return 0;
+}
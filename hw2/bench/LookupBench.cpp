@@ -0,0 +1,46 @@
+// Lookup latency of TreeMap (red-black) against BTreeMap (B+-tree) on maps
+// much larger than the last-level cache.
+//
+//   g++ -std=c++17 -O2 -march=native -I hw2/lib hw2/bench/LookupBench.cpp -o lookup_bench
+#include "BTreeMap.cpp"
+#include "TreeMap.cpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+template <typename Map>
+double time_lookups(const Map &map, const std::vector<int64_t> &probes)
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for (int64_t key : probes)
+        hits += map.find(key) != nullptr;
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (hits == 0)
+        std::printf("(no hits)\n");
+    return elapsed / probes.size();
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    std::mt19937_64 rng(36);
+
+    std::vector<std::pair<int64_t, int64_t>> entries(n);
+    for (size_t i = 0; i < n; i++)
+        entries[i] = {static_cast<int64_t>(i) * 3, static_cast<int64_t>(i)};
+
+    auto tree = TreeMap<int64_t, int64_t>::from_sorted_range(entries.begin(), entries.end());
+    auto btree = BTreeMap<int64_t, int64_t>::from_sorted_range(entries.begin(), entries.end());
+
+    std::vector<int64_t> probes(2'000'000);
+    for (int64_t &probe : probes)
+        probe = static_cast<int64_t>(rng() % (3 * n));
+
+    std::printf("%zu entries, %zu random lookups\n", n, probes.size());
+    std::printf("TreeMap  : %7.1f ns/lookup\n", time_lookups(tree, probes));
+    std::printf("BTreeMap : %7.1f ns/lookup\n", time_lookups(btree, probes));
+    return 0;
+}
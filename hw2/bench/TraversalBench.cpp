@@ -0,0 +1,62 @@
+// Throughput of full-tree walks on a large TreeSet: to_vector(), copying
+// and clear(), each touching every node once.
+//
+//   g++ -std=c++17 -O2 -I hw2/lib hw2/bench/TraversalBench.cpp -o traversal_bench
+#include "TreeSet.cpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Not trivially destructible, so clear() has to visit every node
+struct Payload
+{
+    int value;
+
+    Payload(int value) : value(value) {}
+    ~Payload() {}
+
+    bool operator<(const Payload &other) const { return value < other.value; }
+};
+
+template <typename F>
+double seconds(F body)
+{
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, size_t n, double elapsed)
+{
+    std::printf("%-12s %8.3f s  %8.1f M nodes/s\n", name, elapsed, n / elapsed / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 10'000'000;
+
+    std::vector<Payload> items;
+    items.reserve(n);
+    for (size_t i = 0; i < n; i++)
+        items.emplace_back(static_cast<int>(i));
+
+    auto tree = TreeSet<Payload>::from_sorted_range(items.begin(), items.end());
+    items.clear();
+    items.shrink_to_fit();
+
+    std::vector<Payload> out;
+    report("to_vector", n, seconds([&]()
+                                   { out = tree.to_vector(); }));
+    if (out.size() != n)
+        std::printf("(size mismatch)\n");
+    out.clear();
+    out.shrink_to_fit();
+
+    TreeSet<Payload> copy;
+    report("copy", n, seconds([&]()
+                              { copy = tree; }));
+    report("clear", n, seconds([&]()
+                               { copy.clear(); }));
+    return 0;
+}
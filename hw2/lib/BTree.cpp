@@ -0,0 +1,817 @@
+#ifndef B_TREE_CPP
+#define B_TREE_CPP
+
+#include "BTree.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+// The AVX2 key scan is compiled with GCC target pragmas and picked at run
+// time, so plain -O2 builds use it on CPUs that have it
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define B_TREE_X86 1
+#include <immintrin.h>
+#else
+#define B_TREE_X86 0
+#endif
+
+#if B_TREE_X86
+
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+
+// count_greater_avx2() - Number of lanes where a > b
+template <typename TKey>
+inline size_t count_greater_avx2(__m256i a, __m256i b)
+{
+    if constexpr (sizeof(TKey) == 4)
+        return __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))));
+    else
+        return __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))));
+}
+
+// count_keys_before_avx2() - count_keys_before() over the whole 32-byte
+// blocks of keys; sets scanned to the number of keys it covered
+template <bool Descending, bool Inclusive, typename TKey>
+size_t count_keys_before_avx2(const TKey *keys, size_t count, TKey key, size_t &scanned)
+{
+    constexpr size_t lanes = 32 / sizeof(TKey);
+    __m256i needle = sizeof(TKey) == 4 ? _mm256_set1_epi32(static_cast<int32_t>(key))
+                                       : _mm256_set1_epi64x(static_cast<int64_t>(key));
+    size_t result = 0;
+    size_t i = 0;
+    // Every case reduces to counting lanes where a > b, possibly negated
+    for (; i + lanes <= count; i += lanes)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+        if constexpr (!Descending && !Inclusive)
+            result += count_greater_avx2<TKey>(needle, block); // keys < key
+        else if constexpr (!Descending && Inclusive)
+            result += lanes - count_greater_avx2<TKey>(block, needle); // keys <= key
+        else if constexpr (Descending && !Inclusive)
+            result += count_greater_avx2<TKey>(block, needle); // keys > key
+        else
+            result += lanes - count_greater_avx2<TKey>(needle, block); // keys >= key
+    }
+    scanned = i;
+    return result;
+}
+
+#pragma GCC pop_options
+
+#endif
+
+// b_tree_avx2_supported() - Whether this CPU runs the AVX2 key scan; checked once
+inline bool b_tree_avx2_supported()
+{
+#if B_TREE_X86
+    static const bool supported = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// count_keys_before() - Branch-free count of keys ordered before key under std::less
+// (Descending: std::greater), or of keys not ordered after it when Inclusive. The
+// fixed loop over arithmetic keys auto-vectorizes; 32/64-bit integers take the
+// AVX2 scan when the CPU supports it.
+template <bool Descending, bool Inclusive, typename TKey>
+size_t count_keys_before(const TKey *keys, size_t count, TKey key)
+{
+    size_t i = 0;
+    size_t result = 0;
+
+#if B_TREE_X86
+    if constexpr (std::is_integral_v<TKey> && std::is_signed_v<TKey> && (sizeof(TKey) == 4 || sizeof(TKey) == 8))
+    {
+        if (b_tree_avx2_supported())
+            result = count_keys_before_avx2<Descending, Inclusive>(keys, count, key, i);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if constexpr (!Descending && !Inclusive)
+            result += keys[i] < key;
+        else if constexpr (!Descending && Inclusive)
+            result += !(key < keys[i]);
+        else if constexpr (Descending && !Inclusive)
+            result += keys[i] > key;
+        else
+            result += !(key > keys[i]);
+    }
+    return result;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare>::BTree() : BTree(Compare()) {}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare>::BTree(const Compare &comparator)
+    : ComparatorStorage<Compare>(comparator), _root(nullptr), _first(nullptr), _last(nullptr), _size(0) {}
+
+// Copy constructor - Rebuilds the copy bottom-up from the sorted entries, with packed leaves
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare>::BTree(const BTree &other) : BTree(other.comparator())
+{
+    build_sorted(other.begin(), other._size);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare>::BTree(BTree &&other) noexcept(std::is_nothrow_copy_constructible_v<Compare>)
+    : ComparatorStorage<Compare>(other.comparator()), _root(std::exchange(other._root, nullptr)),
+      _first(std::exchange(other._first, nullptr)), _last(std::exchange(other._last, nullptr)),
+      _size(std::exchange(other._size, 0)) {}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare> &BTree<TKey, TValue, Compare>::operator=(const BTree &other)
+{
+    if (this != &other)
+    {
+        BTree copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare> &BTree<TKey, TValue, Compare>::operator=(BTree &&other) noexcept(
+    std::is_nothrow_copy_assignable_v<Compare>)
+{
+    if (this != &other)
+    {
+        // The comparator goes first so a throwing copy leaves this tree intact
+        ComparatorStorage<Compare>::operator=(other);
+        clear();
+        _root = std::exchange(other._root, nullptr);
+        _first = std::exchange(other._first, nullptr);
+        _last = std::exchange(other._last, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+BTree<TKey, TValue, Compare>::~BTree()
+{
+    clear();
+}
+
+// lower_index() - Number of keys in node ordered before key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+size_t BTree<TKey, TValue, Compare>::lower_index(const Node *node, const K &key) const
+{
+    if constexpr (std::is_arithmetic_v<TKey> && std::is_same_v<K, TKey> &&
+                  (std::is_same_v<Compare, std::less<TKey>> || std::is_same_v<Compare, std::less<>>))
+        return count_keys_before<false, false>(node->_keys, node->_count, key);
+    else if constexpr (std::is_arithmetic_v<TKey> && std::is_same_v<K, TKey> &&
+                       (std::is_same_v<Compare, std::greater<TKey>> || std::is_same_v<Compare, std::greater<>>))
+        return count_keys_before<true, false>(node->_keys, node->_count, key);
+    else
+        return std::lower_bound(node->_keys, node->_keys + node->_count, key, comparator()) - node->_keys;
+}
+
+// upper_index() - Number of keys in node not ordered after key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+size_t BTree<TKey, TValue, Compare>::upper_index(const Node *node, const K &key) const
+{
+    if constexpr (std::is_arithmetic_v<TKey> && std::is_same_v<K, TKey> &&
+                  (std::is_same_v<Compare, std::less<TKey>> || std::is_same_v<Compare, std::less<>>))
+        return count_keys_before<false, true>(node->_keys, node->_count, key);
+    else if constexpr (std::is_arithmetic_v<TKey> && std::is_same_v<K, TKey> &&
+                       (std::is_same_v<Compare, std::greater<TKey>> || std::is_same_v<Compare, std::greater<>>))
+        return count_keys_before<true, true>(node->_keys, node->_count, key);
+    else
+        return std::upper_bound(node->_keys, node->_keys + node->_count, key, comparator()) - node->_keys;
+}
+
+// find_leaf() - Descends to the only leaf whose key range can hold key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+const typename BTree<TKey, TValue, Compare>::Leaf *BTree<TKey, TValue, Compare>::find_leaf(const K &key) const
+{
+    const Node *node = _root;
+    if (node == nullptr)
+        return nullptr;
+    while (!node->_leaf)
+    {
+        const Inner *inner = static_cast<const Inner *>(node);
+        node = inner->_children[upper_index(inner, key)];
+    }
+    return static_cast<const Leaf *>(node);
+}
+
+// build_sorted() - Replaces the contents with count ascending entries, filling leaves
+// evenly and then stacking inner levels on top of them
+template <typename TKey, typename TValue, typename Compare>
+template <typename InputIt>
+void BTree<TKey, TValue, Compare>::build_sorted(InputIt first, size_t count)
+{
+    clear();
+    if (count == 0)
+        return;
+
+    std::vector<Node *> level;
+    std::vector<const TKey *> smallest; // first key below each node of the level
+
+    size_t leaves = (count + SLOTS - 1) / SLOTS;
+    Leaf *previous = nullptr;
+    for (size_t l = 0; l < leaves; l++)
+    {
+        Leaf *leaf = new Leaf();
+        size_t take = count / leaves + (l < count % leaves ? 1 : 0);
+        for (size_t j = 0; j < take; j++, ++first)
+        {
+            if constexpr (IS_SET)
+            {
+                leaf->_keys[j] = *first;
+            }
+            else
+            {
+                leaf->_keys[j] = first->first;
+                leaf->_values[j] = first->second;
+            }
+        }
+        leaf->_count = take;
+
+        leaf->_prev = previous;
+        if (previous != nullptr)
+            previous->_next = leaf;
+        previous = leaf;
+
+        level.push_back(leaf);
+        smallest.push_back(&leaf->_keys[0]);
+    }
+    _first = static_cast<Leaf *>(level.front());
+    _last = previous;
+
+    while (level.size() > 1)
+    {
+        std::vector<Node *> parents;
+        std::vector<const TKey *> parents_smallest;
+        size_t groups = (level.size() + SLOTS) / (SLOTS + 1);
+        size_t position = 0;
+        for (size_t g = 0; g < groups; g++)
+        {
+            Inner *inner = new Inner();
+            size_t take = level.size() / groups + (g < level.size() % groups ? 1 : 0);
+            for (size_t j = 0; j < take; j++)
+            {
+                inner->_children[j] = level[position + j];
+                if (j > 0)
+                    inner->_keys[j - 1] = *smallest[position + j];
+            }
+            inner->_count = take - 1;
+
+            parents.push_back(inner);
+            parents_smallest.push_back(smallest[position]);
+            position += take;
+        }
+        level.swap(parents);
+        smallest.swap(parents_smallest);
+    }
+
+    _root = level.front();
+    _size = count;
+}
+
+// insert_entry() - Inserts into the leaf found by descent, splitting full nodes on the way back up
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename V>
+std::pair<typename BTree<TKey, TValue, Compare>::const_iterator, bool>
+BTree<TKey, TValue, Compare>::insert_entry(K &&key, V &&value, bool assign)
+{
+    if (_root == nullptr)
+    {
+        Leaf *leaf = new Leaf();
+        _root = _first = _last = leaf;
+    }
+
+    Inner *path[MAX_DEPTH];
+    size_t slots[MAX_DEPTH];
+    size_t depth = 0;
+
+    Node *node = _root;
+    while (!node->_leaf)
+    {
+        Inner *inner = static_cast<Inner *>(node);
+        size_t slot = upper_index(inner, key);
+        path[depth] = inner;
+        slots[depth] = slot;
+        depth++;
+        node = inner->_children[slot];
+    }
+
+    Leaf *leaf = static_cast<Leaf *>(node);
+    size_t index = lower_index(leaf, key);
+    if (index < leaf->_count && !comparator()(key, leaf->_keys[index]))
+    {
+        if (assign)
+        {
+            leaf->_keys[index] = std::forward<K>(key);
+            leaf->_values[index] = std::forward<V>(value);
+        }
+        return {const_iterator(leaf, index, this), false};
+    }
+
+    Leaf *target = leaf;
+    Leaf *split = nullptr;
+    if (leaf->_count == SLOTS)
+    {
+        // Move the upper half into a new right sibling
+        size_t mid = SLOTS / 2;
+        split = new Leaf();
+        for (size_t j = mid; j < SLOTS; j++)
+        {
+            split->_keys[j - mid] = std::move(leaf->_keys[j]);
+            split->_values[j - mid] = std::move(leaf->_values[j]);
+        }
+        split->_count = SLOTS - mid;
+        leaf->_count = mid;
+
+        split->_next = leaf->_next;
+        split->_prev = leaf;
+        if (leaf->_next != nullptr)
+            leaf->_next->_prev = split;
+        else
+            _last = split;
+        leaf->_next = split;
+
+        if (index > mid)
+        {
+            target = split;
+            index -= mid;
+        }
+    }
+
+    for (size_t j = target->_count; j > index; j--)
+    {
+        target->_keys[j] = std::move(target->_keys[j - 1]);
+        target->_values[j] = std::move(target->_values[j - 1]);
+    }
+    target->_keys[index] = std::forward<K>(key);
+    target->_values[index] = std::forward<V>(value);
+    target->_count++;
+    _size++;
+
+    if (split == nullptr)
+        return {const_iterator(target, index, this), true};
+
+    // Hand the separator up, splitting full inner nodes as needed
+    TKey separator = split->_keys[0];
+    Node *right = split;
+    while (depth > 0)
+    {
+        depth--;
+        Inner *parent = path[depth];
+        size_t slot = slots[depth];
+
+        if (parent->_count < SLOTS)
+        {
+            for (size_t j = parent->_count; j > slot; j--)
+            {
+                parent->_keys[j] = std::move(parent->_keys[j - 1]);
+                parent->_children[j + 1] = parent->_children[j];
+            }
+            parent->_keys[slot] = std::move(separator);
+            parent->_children[slot + 1] = right;
+            parent->_count++;
+            return {const_iterator(target, index, this), true};
+        }
+
+        TKey keys[SLOTS + 1];
+        Node *children[SLOTS + 2];
+        for (size_t j = 0, k = 0; j <= SLOTS; j++)
+            keys[j] = j == slot ? std::move(separator) : std::move(parent->_keys[k++]);
+        for (size_t j = 0, k = 0; j <= SLOTS + 1; j++)
+            children[j] = j == slot + 1 ? right : parent->_children[k++];
+
+        size_t mid = (SLOTS + 1) / 2; // keys[mid] moves up
+        Inner *sibling = new Inner();
+        for (size_t j = 0; j < mid; j++)
+        {
+            parent->_keys[j] = std::move(keys[j]);
+            parent->_children[j] = children[j];
+        }
+        parent->_children[mid] = children[mid];
+        parent->_count = mid;
+
+        for (size_t j = mid + 1; j <= SLOTS; j++)
+        {
+            sibling->_keys[j - mid - 1] = std::move(keys[j]);
+            sibling->_children[j - mid - 1] = children[j];
+        }
+        sibling->_children[SLOTS - mid] = children[SLOTS + 1];
+        sibling->_count = SLOTS - mid;
+
+        separator = std::move(keys[mid]);
+        right = sibling;
+    }
+
+    Inner *root = new Inner();
+    root->_keys[0] = std::move(separator);
+    root->_children[0] = _root;
+    root->_children[1] = right;
+    root->_count = 1;
+    _root = root;
+
+    return {const_iterator(target, index, this), true};
+}
+
+// erase_key() - Removes key from its leaf, then restores the minimum fill
+// on the way back up: a node left short borrows an entry from a sibling
+// that can spare one, or else merges with it, which takes a child out of
+// the parent. A root inner node left with one child is replaced by it.
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+bool BTree<TKey, TValue, Compare>::erase_key(const K &key)
+{
+    if (_root == nullptr)
+        return false;
+
+    Inner *path[MAX_DEPTH];
+    size_t slots[MAX_DEPTH];
+    size_t depth = 0;
+
+    Node *node = _root;
+    while (!node->_leaf)
+    {
+        Inner *inner = static_cast<Inner *>(node);
+        size_t slot = upper_index(inner, key);
+        path[depth] = inner;
+        slots[depth] = slot;
+        depth++;
+        node = inner->_children[slot];
+    }
+
+    Leaf *leaf = static_cast<Leaf *>(node);
+    size_t index = lower_index(leaf, key);
+    if (index == leaf->_count || comparator()(key, leaf->_keys[index]))
+        return false;
+
+    for (size_t j = index + 1; j < leaf->_count; j++)
+    {
+        leaf->_keys[j - 1] = std::move(leaf->_keys[j]);
+        leaf->_values[j - 1] = std::move(leaf->_values[j]);
+    }
+    leaf->_count--;
+    leaf->_keys[leaf->_count] = TKey();
+    leaf->_values[leaf->_count] = TValue();
+
+    if (--_size == 0)
+    {
+        clear();
+        return true;
+    }
+    if (depth == 0 || leaf->_count >= MIN_LEAF_COUNT)
+        return true;
+
+    rebalance_leaf(leaf, path[depth - 1], slots[depth - 1]);
+    for (size_t level = depth - 1; level > 0; level--)
+    {
+        if (path[level]->_count >= MIN_INNER_COUNT)
+            return true;
+        rebalance_inner(path[level], path[level - 1], slots[level - 1]);
+    }
+
+    if (_root->_count == 0)
+    {
+        Inner *root = static_cast<Inner *>(_root);
+        _root = root->_children[0];
+        delete root;
+    }
+    return true;
+}
+
+// remove_child() - Drops parent's key at key_index and the child to its right
+template <typename TKey, typename TValue, typename Compare>
+void BTree<TKey, TValue, Compare>::remove_child(Inner *parent, size_t key_index)
+{
+    for (size_t j = key_index + 1; j < parent->_count; j++)
+    {
+        parent->_keys[j - 1] = std::move(parent->_keys[j]);
+        parent->_children[j] = parent->_children[j + 1];
+    }
+    parent->_count--;
+    parent->_keys[parent->_count] = TKey();
+}
+
+// rebalance_leaf() - Refills leaf, child slot of parent, from a sibling or merges it into one
+template <typename TKey, typename TValue, typename Compare>
+void BTree<TKey, TValue, Compare>::rebalance_leaf(Leaf *leaf, Inner *parent, size_t slot)
+{
+    Leaf *left = slot > 0 ? static_cast<Leaf *>(parent->_children[slot - 1]) : nullptr;
+    Leaf *right = slot < parent->_count ? static_cast<Leaf *>(parent->_children[slot + 1]) : nullptr;
+
+    if (left != nullptr && left->_count > MIN_LEAF_COUNT)
+    {
+        // Take the left sibling's last entry; it becomes the new separator
+        for (size_t j = leaf->_count; j > 0; j--)
+        {
+            leaf->_keys[j] = std::move(leaf->_keys[j - 1]);
+            leaf->_values[j] = std::move(leaf->_values[j - 1]);
+        }
+        left->_count--;
+        leaf->_keys[0] = std::move(left->_keys[left->_count]);
+        leaf->_values[0] = std::move(left->_values[left->_count]);
+        left->_keys[left->_count] = TKey();
+        left->_values[left->_count] = TValue();
+        leaf->_count++;
+        parent->_keys[slot - 1] = leaf->_keys[0];
+        return;
+    }
+
+    if (right != nullptr && right->_count > MIN_LEAF_COUNT)
+    {
+        // Take the right sibling's first entry; its new first key becomes the separator
+        leaf->_keys[leaf->_count] = std::move(right->_keys[0]);
+        leaf->_values[leaf->_count] = std::move(right->_values[0]);
+        leaf->_count++;
+        for (size_t j = 1; j < right->_count; j++)
+        {
+            right->_keys[j - 1] = std::move(right->_keys[j]);
+            right->_values[j - 1] = std::move(right->_values[j]);
+        }
+        right->_count--;
+        right->_keys[right->_count] = TKey();
+        right->_values[right->_count] = TValue();
+        parent->_keys[slot] = right->_keys[0];
+        return;
+    }
+
+    // Neither sibling can spare an entry, so two leaves fit in one
+    size_t key_index = left != nullptr ? slot - 1 : slot;
+    if (left == nullptr)
+    {
+        left = leaf;
+        leaf = right;
+    }
+    for (size_t j = 0; j < leaf->_count; j++)
+    {
+        left->_keys[left->_count + j] = std::move(leaf->_keys[j]);
+        left->_values[left->_count + j] = std::move(leaf->_values[j]);
+    }
+    left->_count += leaf->_count;
+
+    left->_next = leaf->_next;
+    if (leaf->_next != nullptr)
+        leaf->_next->_prev = left;
+    else
+        _last = left;
+    delete leaf;
+    remove_child(parent, key_index);
+}
+
+// rebalance_inner() - Refills node, child slot of parent, by rotating a key
+// through the parent from a sibling, or merges it with a sibling around
+// the separator between them
+template <typename TKey, typename TValue, typename Compare>
+void BTree<TKey, TValue, Compare>::rebalance_inner(Inner *node, Inner *parent, size_t slot)
+{
+    Inner *left = slot > 0 ? static_cast<Inner *>(parent->_children[slot - 1]) : nullptr;
+    Inner *right = slot < parent->_count ? static_cast<Inner *>(parent->_children[slot + 1]) : nullptr;
+
+    if (left != nullptr && left->_count > MIN_INNER_COUNT)
+    {
+        for (size_t j = node->_count; j > 0; j--)
+            node->_keys[j] = std::move(node->_keys[j - 1]);
+        for (size_t j = node->_count + 1; j > 0; j--)
+            node->_children[j] = node->_children[j - 1];
+        node->_keys[0] = std::move(parent->_keys[slot - 1]);
+        node->_children[0] = left->_children[left->_count];
+        node->_count++;
+
+        left->_count--;
+        parent->_keys[slot - 1] = std::move(left->_keys[left->_count]);
+        left->_keys[left->_count] = TKey();
+        return;
+    }
+
+    if (right != nullptr && right->_count > MIN_INNER_COUNT)
+    {
+        node->_keys[node->_count] = std::move(parent->_keys[slot]);
+        node->_children[node->_count + 1] = right->_children[0];
+        node->_count++;
+
+        parent->_keys[slot] = std::move(right->_keys[0]);
+        for (size_t j = 1; j < right->_count; j++)
+            right->_keys[j - 1] = std::move(right->_keys[j]);
+        for (size_t j = 1; j <= right->_count; j++)
+            right->_children[j - 1] = right->_children[j];
+        right->_count--;
+        right->_keys[right->_count] = TKey();
+        return;
+    }
+
+    size_t key_index = left != nullptr ? slot - 1 : slot;
+    if (left == nullptr)
+    {
+        left = node;
+        node = right;
+    }
+    left->_keys[left->_count] = std::move(parent->_keys[key_index]);
+    for (size_t j = 0; j < node->_count; j++)
+        left->_keys[left->_count + 1 + j] = std::move(node->_keys[j]);
+    for (size_t j = 0; j <= node->_count; j++)
+        left->_children[left->_count + 1 + j] = node->_children[j];
+    left->_count += node->_count + 1;
+    delete node;
+    remove_child(parent, key_index);
+}
+
+// find_entry() - Iterator to the entry equivalent to key, or end()
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::find_entry(const K &key) const
+{
+    const Leaf *leaf = find_leaf(key);
+    if (leaf == nullptr)
+        return end();
+
+    size_t index = lower_index(leaf, key);
+    if (index == leaf->_count || comparator()(key, leaf->_keys[index]))
+        return end();
+    return const_iterator(leaf, index, this);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+size_t BTree<TKey, TValue, Compare>::size() const
+{
+    return _size;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool BTree<TKey, TValue, Compare>::is_empty() const
+{
+    return _size == 0;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool BTree<TKey, TValue, Compare>::is_balanced() const
+{
+    if (_root == nullptr)
+        return _size == 0;
+    size_t leaf_depth = 0;
+    return check_node(_root, nullptr, nullptr, 1, leaf_depth);
+}
+
+// check_node() - Validates a subtree whose keys must lie in [lower, upper); null bounds are open
+template <typename TKey, typename TValue, typename Compare>
+bool BTree<TKey, TValue, Compare>::check_node(const Node *node, const TKey *lower, const TKey *upper, size_t depth,
+                                              size_t &leaf_depth) const
+{
+    size_t minimum = 1;
+    if (node != _root)
+        minimum = node->_leaf ? MIN_LEAF_COUNT : MIN_INNER_COUNT;
+    if (node->_count < minimum || node->_count > SLOTS)
+        return false;
+    for (size_t j = 0; j < node->_count; j++)
+    {
+        if (lower != nullptr && comparator()(node->_keys[j], *lower))
+            return false;
+        if (upper != nullptr && !comparator()(node->_keys[j], *upper))
+            return false;
+        if (j > 0 && !comparator()(node->_keys[j - 1], node->_keys[j]))
+            return false;
+    }
+
+    if (node->_leaf)
+    {
+        if (leaf_depth == 0)
+            leaf_depth = depth;
+        return depth == leaf_depth;
+    }
+
+    const Inner *inner = static_cast<const Inner *>(node);
+    for (size_t j = 0; j <= inner->_count; j++)
+    {
+        const TKey *child_lower = j == 0 ? lower : &inner->_keys[j - 1];
+        const TKey *child_upper = j == inner->_count ? upper : &inner->_keys[j];
+        if (!check_node(inner->_children[j], child_lower, child_upper, depth + 1, leaf_depth))
+            return false;
+    }
+    return true;
+}
+
+// key_comp() - Returns a copy of the comparator ordering the tree
+template <typename TKey, typename TValue, typename Compare>
+Compare BTree<TKey, TValue, Compare>::key_comp() const
+{
+    return comparator();
+}
+
+// destroy() - Frees a subtree
+template <typename TKey, typename TValue, typename Compare>
+void BTree<TKey, TValue, Compare>::destroy(Node *node)
+{
+    if (node->_leaf)
+    {
+        delete static_cast<Leaf *>(node);
+        return;
+    }
+
+    Inner *inner = static_cast<Inner *>(node);
+    for (size_t j = 0; j <= inner->_count; j++)
+        destroy(inner->_children[j]);
+    delete inner;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void BTree<TKey, TValue, Compare>::clear()
+{
+    if (_root != nullptr)
+        destroy(_root);
+    _root = nullptr;
+    _first = _last = nullptr;
+    _size = 0;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::begin() const
+{
+    return const_iterator(_first, 0, this);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::end() const
+{
+    return const_iterator(nullptr, 0, this);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_reverse_iterator BTree<TKey, TValue, Compare>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_reverse_iterator BTree<TKey, TValue, Compare>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+// lower_bound() - First entry whose key is not ordered before key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::lower_bound(const K &key) const
+{
+    const Leaf *leaf = find_leaf(key);
+    if (leaf == nullptr)
+        return end();
+    return const_iterator(leaf, lower_index(leaf, key), this);
+}
+
+// upper_bound() - First entry whose key is ordered after key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::upper_bound(const K &key) const
+{
+    const Leaf *leaf = find_leaf(key);
+    if (leaf == nullptr)
+        return end();
+    return const_iterator(leaf, upper_index(leaf, key), this);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+std::pair<typename BTree<TKey, TValue, Compare>::const_iterator, typename BTree<TKey, TValue, Compare>::const_iterator>
+BTree<TKey, TValue, Compare>::equal_range(const K &key) const
+{
+    return {lower_bound(key), upper_bound(key)};
+}
+
+// erase() - Removes the entry at position, then finds its successor again by key
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::erase(const_iterator position)
+{
+    TKey key = position.key();
+    erase_key(key);
+    return lower_bound(key);
+}
+
+// erase() - Removes [first, last) one entry at a time; last is remembered by key since merges move entries
+template <typename TKey, typename TValue, typename Compare>
+typename BTree<TKey, TValue, Compare>::const_iterator BTree<TKey, TValue, Compare>::erase(const_iterator first,
+                                                                                         const_iterator last)
+{
+    if (last == end())
+    {
+        while (first != end())
+            first = erase(first);
+        return end();
+    }
+
+    TKey stop = last.key();
+    while (comparator()(first.key(), stop))
+        first = erase(first);
+    return first;
+}
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef B_TREE_HPP
+#define B_TREE_HPP
+
+#include "TreeSet.hpp"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Value type of a B-tree used as a set; it takes no room in the leaves.
+struct BTreeNoValue
+{
+};
+
+// B+-tree core shared by BTreeSet and BTreeMap. Nodes are a few cache lines
+// wide and keep their keys in one contiguous array, so a lookup touches
+// O(log_B n) nodes and scans each with a branch-free (SIMD for arithmetic
+// keys) count instead of chasing one pointer per comparison. Values live in
+// a parallel array in the leaves, and the leaves form a doubly linked list
+// for in-order iteration.
+//
+// Every node but the root stays at least half full: a deletion that leaves
+// a node short borrows from a sibling or merges with it, and empty nodes
+// are freed, so a tree that shrinks keeps O(n / B) nodes.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class BTree : private ComparatorStorage<Compare>
+{
+protected:
+    static constexpr bool IS_SET = std::is_same_v<TValue, BTreeNoValue>;
+    static constexpr size_t NODE_BYTES = 256;
+    static constexpr size_t SLOTS = NODE_BYTES / sizeof(TKey) < 8 ? 8 : NODE_BYTES / sizeof(TKey);
+    static constexpr size_t MAX_DEPTH = 48;
+    // Fewest entries in a leaf and keys in an inner node, except at the root
+    static constexpr size_t MIN_LEAF_COUNT = SLOTS / 2;
+    static constexpr size_t MIN_INNER_COUNT = (SLOTS - 1) / 2;
+
+    template <typename V, bool = std::is_empty_v<V>>
+    struct ValueArray
+    {
+        V values[SLOTS];
+        V &operator[](size_t i) { return values[i]; }
+        const V &operator[](size_t i) const { return values[i]; }
+    };
+
+    template <typename V>
+    struct ValueArray<V, true>
+    {
+        V &operator[](size_t) { return empty_value; }
+        const V &operator[](size_t) const { return empty_value; }
+        static inline V empty_value{};
+    };
+
+    struct alignas(64) Node
+    {
+        bool _leaf;
+        size_t _count;
+        TKey _keys[SLOTS];
+
+        explicit Node(bool leaf) : _leaf(leaf), _count(0) {}
+    };
+
+    struct Leaf : Node
+    {
+        ValueArray<TValue> _values;
+        Leaf *_next;
+        Leaf *_prev;
+
+        Leaf() : Node(true), _next(nullptr), _prev(nullptr) {}
+    };
+
+    // _keys[i] separates _children[i] (keys below it) from _children[i + 1] (keys not below it)
+    struct Inner : Node
+    {
+        Node *_children[SLOTS + 1];
+
+        Inner() : Node(false) {}
+    };
+
+    Node *_root;
+    Leaf *_first;
+    Leaf *_last;
+    size_t _size;
+
+    using ComparatorStorage<Compare>::comparator;
+
+    template <typename K>
+    size_t lower_index(const Node *node, const K &key) const;
+    template <typename K>
+    size_t upper_index(const Node *node, const K &key) const;
+    template <typename K>
+    const Leaf *find_leaf(const K &key) const;
+
+    template <typename InputIt>
+    void build_sorted(InputIt first, size_t count);
+    void destroy(Node *node);
+
+    void remove_child(Inner *parent, size_t key_index);
+    void rebalance_leaf(Leaf *leaf, Inner *parent, size_t slot);
+    void rebalance_inner(Inner *node, Inner *parent, size_t slot);
+    bool check_node(const Node *node, const TKey *lower, const TKey *upper, size_t depth, size_t &leaf_depth) const;
+
+public:
+    using value_type = std::conditional_t<IS_SET, TKey, std::pair<TKey, TValue>>;
+    using reference = std::conditional_t<IS_SET, const TKey &, std::pair<const TKey &, const TValue &>>;
+
+    // Bidirectional iterator over (leaf, slot) positions
+    class const_iterator
+    {
+    private:
+        friend class BTree;
+
+        const Leaf *_leaf;
+        size_t _index;
+        const BTree *_tree;
+
+        const_iterator(const Leaf *leaf, size_t index, const BTree *tree) : _leaf(leaf), _index(index), _tree(tree)
+        {
+            skip_empty();
+        }
+
+        void skip_empty()
+        {
+            while (_leaf != nullptr && _index >= _leaf->_count)
+            {
+                _leaf = _leaf->_next;
+                _index = 0;
+            }
+        }
+
+        struct ArrowProxy
+        {
+            std::pair<const TKey &, const TValue &> entry;
+            const std::pair<const TKey &, const TValue &> *operator->() const { return &entry; }
+        };
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = BTree::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = BTree::reference;
+        using pointer = std::conditional_t<IS_SET, const TKey *, ArrowProxy>;
+
+        const_iterator() : _leaf(nullptr), _index(0), _tree(nullptr) {}
+
+        const TKey &key() const { return _leaf->_keys[_index]; }
+        const TValue &value() const { return _leaf->_values[_index]; }
+
+        reference operator*() const
+        {
+            if constexpr (IS_SET)
+                return key();
+            else
+                return {key(), value()};
+        }
+        pointer operator->() const
+        {
+            if constexpr (IS_SET)
+                return &key();
+            else
+                return ArrowProxy{{key(), value()}};
+        }
+
+        const_iterator &operator++()
+        {
+            ++_index;
+            skip_empty();
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        const_iterator &operator--()
+        {
+            if (_leaf == nullptr)
+            {
+                _leaf = _tree->_last;
+                _index = _leaf->_count;
+            }
+            while (_index == 0)
+            {
+                _leaf = _leaf->_prev;
+                _index = _leaf->_count;
+            }
+            --_index;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const { return _leaf == other._leaf && _index == other._index; }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+protected:
+    // insert_entry() - Adds key if absent, otherwise optionally overwrites the stored key and value
+    template <typename K, typename V>
+    std::pair<const_iterator, bool> insert_entry(K &&key, V &&value, bool assign);
+    template <typename K>
+    bool erase_key(const K &key);
+    template <typename K>
+    const_iterator find_entry(const K &key) const;
+
+public:
+    BTree();
+    explicit BTree(const Compare &comparator);
+    BTree(const BTree &other);
+    // Moves hand over the nodes, leaving other empty
+    BTree(BTree &&other) noexcept(std::is_nothrow_copy_constructible_v<Compare>);
+    BTree &operator=(const BTree &other);
+    BTree &operator=(BTree &&other) noexcept(std::is_nothrow_copy_assignable_v<Compare>);
+    ~BTree();
+
+    size_t size() const;
+    bool is_empty() const;
+    Compare key_comp() const;
+    // is_balanced() - Checks the B+-tree invariants: ordered keys within the
+    // separators' bounds, all leaves at one depth, non-root nodes half full
+    bool is_balanced() const;
+    void clear();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    template <typename K>
+    const_iterator lower_bound(const K &key) const;
+    template <typename K>
+    const_iterator upper_bound(const K &key) const;
+    template <typename K>
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+    // erase() - Deletes the entry at position or every entry in [first, last);
+    // returns the iterator after them. Nodes may merge, so other iterators
+    // are invalidated.
+    const_iterator erase(const_iterator position);
+    const_iterator erase(const_iterator first, const_iterator last);
+};
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef B_TREE_MAP_CPP
+#define B_TREE_MAP_CPP
+
+#include "BTreeMap.hpp"
+#include "BTree.cpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+template <typename TKey, typename TValue, typename Compare>
+BTreeMap<TKey, TValue, Compare>::BTreeMap() : Base() {}
+
+template <typename TKey, typename TValue, typename Compare>
+BTreeMap<TKey, TValue, Compare>::BTreeMap(const Compare &comparator) : Base(comparator) {}
+
+// Constructor with a vector of items; sorted input is bulk loaded in linear time
+template <typename TKey, typename TValue, typename Compare>
+BTreeMap<TKey, TValue, Compare>::BTreeMap(const std::vector<std::pair<TKey, TValue>> &items) : Base()
+{
+    load(items);
+}
+
+// load() - Bulk-loads packed leaves when the keys are strictly ascending;
+// otherwise inserts one by one, so a repeated key keeps its last value
+template <typename TKey, typename TValue, typename Compare>
+void BTreeMap<TKey, TValue, Compare>::load(const std::vector<std::pair<TKey, TValue>> &items)
+{
+    auto out_of_order = std::adjacent_find(items.begin(), items.end(),
+                                           [this](const std::pair<TKey, TValue> &left, const std::pair<TKey, TValue> &right)
+                                           { return !this->comparator()(left.first, right.first); });
+    if (out_of_order == items.end())
+    {
+        this->build_sorted(items.begin(), items.size());
+        return;
+    }
+
+    for (const auto &item : items)
+    {
+        insert(item.first, item.second);
+    }
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename InputIt>
+BTreeMap<TKey, TValue, Compare> BTreeMap<TKey, TValue, Compare>::from_sorted_range(InputIt first, InputIt last,
+                                                                                   const Compare &comparator)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    BTreeMap result(comparator);
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>)
+    {
+        result.build_sorted(first, static_cast<size_t>(std::distance(first, last)));
+    }
+    else
+    {
+        std::vector<std::pair<TKey, TValue>> buffered(first, last);
+        result.build_sorted(buffered.begin(), buffered.size());
+    }
+    return result;
+}
+
+// insert() - Adds the entry, replacing the value if the key is already present
+template <typename TKey, typename TValue, typename Compare>
+void BTreeMap<TKey, TValue, Compare>::insert(TKey key, TValue value)
+{
+    this->insert_entry(std::move(key), std::move(value), true);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool BTreeMap<TKey, TValue, Compare>::erase(const TKey &key)
+{
+    return this->erase_key(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::optional<TValue> BTreeMap<TKey, TValue, Compare>::get(const TKey &key) const
+{
+    const TValue *value = find(key);
+
+    if (value)
+    {
+        return *value;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool BTreeMap<TKey, TValue, Compare>::contains(const TKey &key) const
+{
+    return this->find_entry(key) != this->end();
+}
+
+// find() - Points at the stored value for key, or nullptr; leaves own their values mutably
+template <typename TKey, typename TValue, typename Compare>
+TValue *BTreeMap<TKey, TValue, Compare>::find(const TKey &key)
+{
+    return const_cast<TValue *>(static_cast<const BTreeMap *>(this)->find(key));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TValue *BTreeMap<TKey, TValue, Compare>::find(const TKey &key) const
+{
+    const_iterator it = this->find_entry(key);
+    return it == this->end() ? nullptr : &it.value();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::pair<TKey, TValue>> BTreeMap<TKey, TValue, Compare>::to_vector() const
+{
+    std::vector<std::pair<TKey, TValue>> result;
+    result.reserve(this->size());
+    for (const_iterator it = this->begin(); it != this->end(); ++it)
+        result.emplace_back(it.key(), it.value());
+    return result;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+std::optional<TValue> BTreeMap<TKey, TValue, Compare>::get(const K &key) const
+{
+    const TValue *value = find(key);
+    if (value == nullptr)
+        return std::nullopt;
+    return *value;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+bool BTreeMap<TKey, TValue, Compare>::contains(const K &key) const
+{
+    return this->find_entry(key) != this->end();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+TValue *BTreeMap<TKey, TValue, Compare>::find(const K &key)
+{
+    return const_cast<TValue *>(static_cast<const BTreeMap *>(this)->find(key));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+const TValue *BTreeMap<TKey, TValue, Compare>::find(const K &key) const
+{
+    const_iterator it = this->find_entry(key);
+    return it == this->end() ? nullptr : &it.value();
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef B_TREE_MAP_HPP
+#define B_TREE_MAP_HPP
+
+#include "BTree.hpp"
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Ordered map with the TreeMap interface, stored in a B+-tree. Keys sit in
+// contiguous per-node arrays and values in a parallel array in the leaves,
+// so lookups scan keys without pulling values into cache. Iterators yield
+// std::pair<const TKey &, const TValue &> proxies.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class BTreeMap : public BTree<TKey, TValue, Compare>
+{
+private:
+    using Base = BTree<TKey, TValue, Compare>;
+
+    void load(const std::vector<std::pair<TKey, TValue>> &items);
+
+public:
+    using typename Base::const_iterator;
+
+    BTreeMap();
+    explicit BTreeMap(const Compare &comparator);
+    BTreeMap(const std::vector<std::pair<TKey, TValue>> &items);
+
+    // from_sorted_range() - Builds a map from entries with strictly ascending keys
+    template <typename InputIt>
+    static BTreeMap from_sorted_range(InputIt first, InputIt last, const Compare &comparator = Compare());
+
+    void insert(TKey key, TValue value);
+    using Base::erase;
+    bool erase(const TKey &key);
+    std::optional<TValue> get(const TKey &key) const;
+    bool contains(const TKey &key) const;
+    TValue *find(const TKey &key);
+    const TValue *find(const TKey &key) const;
+    std::vector<std::pair<TKey, TValue>> to_vector() const;
+
+    // Heterogeneous lookups, available when Compare declares is_transparent
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::optional<TValue> get(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    TValue *find(const K &key);
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const TValue *find(const K &key) const;
+};
+
+#endif
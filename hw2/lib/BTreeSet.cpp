@@ -0,0 +1,264 @@
+#ifndef B_TREE_SET_CPP
+#define B_TREE_SET_CPP
+
+#include "BTreeSet.hpp"
+#include "BTree.cpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+template <typename T, typename Compare>
+BTreeSet<T, Compare>::BTreeSet() : Base() {}
+
+template <typename T, typename Compare>
+BTreeSet<T, Compare>::BTreeSet(const Compare &comparator) : Base(comparator) {}
+
+// Constructor with a vector of items; sorted input is bulk loaded in linear time
+template <typename T, typename Compare>
+BTreeSet<T, Compare>::BTreeSet(const std::vector<T> &items) : Base()
+{
+    load(items);
+}
+
+// Constructor with both a vector of items and a comparator
+template <typename T, typename Compare>
+BTreeSet<T, Compare>::BTreeSet(const std::vector<T> &items, const Compare &comparator) : Base(comparator)
+{
+    load(items);
+}
+
+// load() - Builds from items, bulk-loading packed leaves when they are already strictly ascending
+template <typename T, typename Compare>
+void BTreeSet<T, Compare>::load(const std::vector<T> &items)
+{
+    auto out_of_order = std::adjacent_find(items.begin(), items.end(), [this](const T &left, const T &right)
+                                           { return !this->comparator()(left, right); });
+    if (out_of_order == items.end())
+    {
+        this->build_sorted(items.begin(), items.size());
+        return;
+    }
+
+    for (const T &item : items)
+    {
+        add(item);
+    }
+}
+
+template <typename T, typename Compare>
+template <typename InputIt>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::from_sorted_range(InputIt first, InputIt last, const Compare &comparator)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    BTreeSet result(comparator);
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>)
+    {
+        result.build_sorted(first, static_cast<size_t>(std::distance(first, last)));
+    }
+    else
+    {
+        std::vector<T> buffered(first, last);
+        result.build_sorted(buffered.begin(), buffered.size());
+    }
+    return result;
+}
+
+// add() - Adds a value to the set, replacing the existing value if present
+template <typename T, typename Compare>
+void BTreeSet<T, Compare>::add(T value)
+{
+    this->insert_entry(std::move(value), BTreeNoValue{}, true);
+}
+
+template <typename T, typename Compare>
+bool BTreeSet<T, Compare>::remove(const T &value)
+{
+    return this->erase_key(value);
+}
+
+template <typename T, typename Compare>
+bool BTreeSet<T, Compare>::contains(const T &value) const
+{
+    return this->find_entry(value) != this->end();
+}
+
+template <typename T, typename Compare>
+std::optional<T> BTreeSet<T, Compare>::get(const T &value) const
+{
+    const T *found = find(value);
+    if (found == nullptr)
+        return std::nullopt;
+    return *found;
+}
+
+// find() - Returns a pointer to the stored element equivalent to value, or nullptr
+template <typename T, typename Compare>
+const T *BTreeSet<T, Compare>::find(const T &value) const
+{
+    const_iterator it = this->find_entry(value);
+    return it == this->end() ? nullptr : &*it;
+}
+
+template <typename T, typename Compare>
+std::optional<T> BTreeSet<T, Compare>::min() const
+{
+    if (this->is_empty())
+        return std::nullopt;
+    return *this->begin();
+}
+
+template <typename T, typename Compare>
+std::optional<T> BTreeSet<T, Compare>::max() const
+{
+    if (this->is_empty())
+        return std::nullopt;
+    return *this->rbegin();
+}
+
+template <typename T, typename Compare>
+std::vector<T> BTreeSet<T, Compare>::to_vector() const
+{
+    std::vector<T> result;
+    result.reserve(this->size());
+    for (const T &value : *this)
+        result.push_back(value);
+    return result;
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+bool BTreeSet<T, Compare>::contains(const K &key) const
+{
+    return this->find_entry(key) != this->end();
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+std::optional<T> BTreeSet<T, Compare>::get(const K &key) const
+{
+    const T *found = find(key);
+    if (found == nullptr)
+        return std::nullopt;
+    return *found;
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+const T *BTreeSet<T, Compare>::find(const K &key) const
+{
+    const_iterator it = this->find_entry(key);
+    return it == this->end() ? nullptr : &*it;
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+bool BTreeSet<T, Compare>::remove(const K &key)
+{
+    return this->erase_key(key);
+}
+
+// combine() - Walks both sets in order once, keeping what the operation selects
+template <typename T, typename Compare>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::combine(const BTreeSet &left, const BTreeSet &right,
+                                                   SetOperation operation)
+{
+    bool keep_left_only = operation != SetOperation::Intersection;
+    bool keep_right_only = operation == SetOperation::Union || operation == SetOperation::SymmetricDifference;
+    const Compare &comparator = left.comparator();
+
+    std::vector<T> merged;
+    const_iterator l = left.begin();
+    const_iterator r = right.begin();
+    while (l != left.end() && r != right.end())
+    {
+        if (comparator(*l, *r))
+        {
+            if (keep_left_only)
+                merged.push_back(*l);
+            ++l;
+        }
+        else if (comparator(*r, *l))
+        {
+            if (keep_right_only)
+                merged.push_back(*r);
+            ++r;
+        }
+        else
+        {
+            if (operation == SetOperation::Union)
+                merged.push_back(*r);
+            else if (operation == SetOperation::Intersection)
+                merged.push_back(*l);
+            ++l;
+            ++r;
+        }
+    }
+    for (; keep_left_only && l != left.end(); ++l)
+        merged.push_back(*l);
+    for (; keep_right_only && r != right.end(); ++r)
+        merged.push_back(*r);
+
+    BTreeSet result(comparator);
+    result.build_sorted(merged.begin(), merged.size());
+    return result;
+}
+
+// operator+ - Union of two sets
+template <typename T, typename Compare>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::operator+(const BTreeSet &other) const
+{
+    return combine(*this, other, SetOperation::Union);
+}
+
+template <typename T, typename Compare>
+BTreeSet<T, Compare> &BTreeSet<T, Compare>::operator+=(const BTreeSet &other)
+{
+    *this = combine(*this, other, SetOperation::Union);
+    return *this;
+}
+
+// operator& - Intersection of two sets
+template <typename T, typename Compare>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::operator&(const BTreeSet &other) const
+{
+    return combine(*this, other, SetOperation::Intersection);
+}
+
+// operator- - Elements of this set that are not in other
+template <typename T, typename Compare>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::operator-(const BTreeSet &other) const
+{
+    return combine(*this, other, SetOperation::Difference);
+}
+
+// operator^ - Elements in exactly one of the two sets
+template <typename T, typename Compare>
+BTreeSet<T, Compare> BTreeSet<T, Compare>::operator^(const BTreeSet &other) const
+{
+    return combine(*this, other, SetOperation::SymmetricDifference);
+}
+
+// operator== - Checks if two sets contain equivalent elements
+template <typename T, typename Compare>
+bool BTreeSet<T, Compare>::operator==(const BTreeSet &other) const
+{
+    if (this->size() != other.size())
+        return false;
+
+    const_iterator r = other.begin();
+    for (const_iterator l = this->begin(); l != this->end(); ++l, ++r)
+    {
+        if (this->comparator()(*l, *r) || this->comparator()(*r, *l))
+            return false;
+    }
+    return true;
+}
+
+template <typename T, typename Compare>
+bool BTreeSet<T, Compare>::operator!=(const BTreeSet &other) const
+{
+    return !(*this == other);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef B_TREE_SET_HPP
+#define B_TREE_SET_HPP
+
+#include "BTree.hpp"
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Ordered set with the TreeSet interface, stored in a B+-tree for
+// cache-friendly lookups on large, read-heavy data. Batched lookups, order
+// statistics and the insert/emplace family stay TreeSet-only.
+template <typename T, typename Compare = std::less<T>>
+class BTreeSet : public BTree<T, BTreeNoValue, Compare>
+{
+private:
+    using Base = BTree<T, BTreeNoValue, Compare>;
+
+    enum class SetOperation
+    {
+        Union,
+        Intersection,
+        Difference,
+        SymmetricDifference
+    };
+
+    void load(const std::vector<T> &items);
+    static BTreeSet combine(const BTreeSet &left, const BTreeSet &right, SetOperation operation);
+
+public:
+    using typename Base::const_iterator;
+
+    BTreeSet();
+    explicit BTreeSet(const Compare &comparator);
+    BTreeSet(const std::vector<T> &items);
+    BTreeSet(const std::vector<T> &items, const Compare &comparator);
+
+    // from_sorted_range() - Builds a set from strictly ascending input with packed leaves
+    template <typename InputIt>
+    static BTreeSet from_sorted_range(InputIt first, InputIt last, const Compare &comparator = Compare());
+
+    void add(T value);
+    bool remove(const T &value);
+    bool contains(const T &value) const;
+    std::optional<T> get(const T &value) const;
+    const T *find(const T &value) const;
+    std::optional<T> min() const;
+    std::optional<T> max() const;
+    std::vector<T> to_vector() const;
+
+    // Lookups by any key the comparator can order against T; only
+    // available when Compare declares is_transparent.
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::optional<T> get(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const T *find(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const K &key);
+
+    // Set algebra merges both sorted sequences in linear time and bulk-loads
+    // the result; elements equivalent under the comparator are taken from
+    // the right operand for +, and from the left one for &.
+    BTreeSet operator+(const BTreeSet &other) const;
+    BTreeSet &operator+=(const BTreeSet &other);
+    BTreeSet operator&(const BTreeSet &other) const;
+    BTreeSet operator-(const BTreeSet &other) const;
+    BTreeSet operator^(const BTreeSet &other) const;
+
+    bool operator==(const BTreeSet &other) const;
+    bool operator!=(const BTreeSet &other) const;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BINARY_TREE_NODE_HPP
+#define BINARY_TREE_NODE_HPP
+
+#include <cstddef>
+#include <utility>
+
+enum Color
+{
+    Red,
+    Black
+};
+
+// Node augmentation policies for TreeSet. The policy's NodeData is a base of
+// every node, so the default adds nothing while OrderStatistics stores the
+// number of nodes in each subtree for rank/select queries.
+struct NoOrderStatistics
+{
+    static constexpr bool enabled = false;
+
+    struct NodeData
+    {
+    };
+};
+
+struct OrderStatistics
+{
+    static constexpr bool enabled = true;
+
+    struct NodeData
+    {
+        size_t _subtree_size = 1;
+    };
+};
+
+template <typename T, typename Stats = NoOrderStatistics>
+class BinaryTreeNode : public Stats::NodeData
+{
+public:
+    T value;
+    BinaryTreeNode<T, Stats> *_left;
+    BinaryTreeNode<T, Stats> *_right;
+    BinaryTreeNode<T, Stats> *_parent;
+    Color _color;
+
+    BinaryTreeNode(T value) : value(std::move(value)), _left(nullptr), _right(nullptr), _parent(nullptr), _color(Red) {}
+
+    // Constructs the value in place from args
+    template <typename... Args>
+    explicit BinaryTreeNode(std::in_place_t, Args &&...args)
+        : value(std::forward<Args>(args)...), _left(nullptr), _right(nullptr), _parent(nullptr), _color(Red) {}
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef CONCURRENT_TREE_MAP_CPP
+#define CONCURRENT_TREE_MAP_CPP
+
+#include "ConcurrentTreeMap.hpp"
+#include "TreeMap.cpp"
+#include <atomic>
+
+template <typename TKey, typename TValue, typename Compare>
+ConcurrentTreeMap<TKey, TValue, Compare>::ConcurrentTreeMap() : _map() {}
+
+template <typename TKey, typename TValue, typename Compare>
+ConcurrentTreeMap<TKey, TValue, Compare>::ConcurrentTreeMap(const Compare &comparator) : _map(comparator) {}
+
+template <typename TKey, typename TValue, typename Compare>
+ConcurrentTreeMap<TKey, TValue, Compare>::ConcurrentTreeMap(const std::vector<std::pair<TKey, TValue>> &items)
+    : _map(items) {}
+
+// shard_index() - Spreads threads over the lock shards in order of first use
+template <typename TKey, typename TValue, typename Compare>
+size_t ConcurrentTreeMap<TKey, TValue, Compare>::shard_index()
+{
+    static std::atomic<size_t> next_thread{0};
+    thread_local size_t index = next_thread.fetch_add(1, std::memory_order_relaxed) % LOCK_SHARDS;
+    return index;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::shared_mutex &ConcurrentTreeMap<TKey, TValue, Compare>::read_mutex() const
+{
+    return _shards[shard_index()].mutex;
+}
+
+// lock_all() - Writers hold every shard, always locked in the same order
+template <typename TKey, typename TValue, typename Compare>
+void ConcurrentTreeMap<TKey, TValue, Compare>::lock_all() const
+{
+    for (LockShard &shard : _shards)
+        shard.mutex.lock();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void ConcurrentTreeMap<TKey, TValue, Compare>::unlock_all() const
+{
+    for (size_t i = LOCK_SHARDS; i > 0; i--)
+        _shards[i - 1].mutex.unlock();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void ConcurrentTreeMap<TKey, TValue, Compare>::insert(TKey key, TValue value)
+{
+    WriteLock lock(*this);
+    _map.insert(std::move(key), std::move(value));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool ConcurrentTreeMap<TKey, TValue, Compare>::erase(const TKey &key)
+{
+    WriteLock lock(*this);
+    return _map.erase(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void ConcurrentTreeMap<TKey, TValue, Compare>::clear()
+{
+    WriteLock lock(*this);
+    _map.clear();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::optional<TValue> ConcurrentTreeMap<TKey, TValue, Compare>::get(const TKey &key) const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    return _map.get(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool ConcurrentTreeMap<TKey, TValue, Compare>::contains(const TKey &key) const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    return _map.contains(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+size_t ConcurrentTreeMap<TKey, TValue, Compare>::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    return _map.size();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool ConcurrentTreeMap<TKey, TValue, Compare>::is_empty() const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    return _map.is_empty();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::pair<TKey, TValue>> ConcurrentTreeMap<TKey, TValue, Compare>::to_vector() const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    return _map.to_vector();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename Visitor>
+bool ConcurrentTreeMap<TKey, TValue, Compare>::visit(const TKey &key, Visitor &&visitor) const
+{
+    std::shared_lock<std::shared_mutex> lock(read_mutex());
+    const TValue *value = _map.find(key);
+    if (value == nullptr)
+        return false;
+    visitor(*value);
+    return true;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename Updater>
+bool ConcurrentTreeMap<TKey, TValue, Compare>::update(const TKey &key, Updater &&updater)
+{
+    WriteLock lock(*this);
+    TValue *value = _map.find(key);
+    if (value == nullptr)
+        return false;
+    updater(*value);
+    return true;
+}
+
+#endif
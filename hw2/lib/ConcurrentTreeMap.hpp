@@ -0,0 +1,76 @@
+#ifndef CONCURRENT_TREE_MAP_HPP
+#define CONCURRENT_TREE_MAP_HPP
+
+#include "TreeMap.hpp"
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+// Thread-safe TreeMap for read-heavy sharing. Reads take a shared lock on
+// one of several cache-line-sized lock shards, picked per thread, so
+// concurrent readers never write to the same cache line; writers take every
+// shard exclusively. Values are handed out by copy or visited under the
+// lock, never by pointer, since a pointer would outlive the lock.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class ConcurrentTreeMap
+{
+private:
+    static constexpr size_t LOCK_SHARDS = 16;
+
+    struct alignas(64) LockShard
+    {
+        std::shared_mutex mutex;
+    };
+
+    TreeMap<TKey, TValue, Compare> _map;
+    mutable LockShard _shards[LOCK_SHARDS];
+
+    // Exclusive hold on every shard for the lifetime of the guard
+    class WriteLock
+    {
+    private:
+        const ConcurrentTreeMap &_owner;
+
+    public:
+        explicit WriteLock(const ConcurrentTreeMap &owner) : _owner(owner) { _owner.lock_all(); }
+        ~WriteLock() { _owner.unlock_all(); }
+        WriteLock(const WriteLock &) = delete;
+        WriteLock &operator=(const WriteLock &) = delete;
+    };
+
+    static size_t shard_index();
+    std::shared_mutex &read_mutex() const;
+    void lock_all() const;
+    void unlock_all() const;
+
+public:
+    ConcurrentTreeMap();
+    explicit ConcurrentTreeMap(const Compare &comparator);
+    ConcurrentTreeMap(const std::vector<std::pair<TKey, TValue>> &items);
+    ConcurrentTreeMap(const ConcurrentTreeMap &) = delete;
+    ConcurrentTreeMap &operator=(const ConcurrentTreeMap &) = delete;
+
+    void insert(TKey key, TValue value);
+    bool erase(const TKey &key);
+    void clear();
+
+    std::optional<TValue> get(const TKey &key) const;
+    bool contains(const TKey &key) const;
+    size_t size() const;
+    bool is_empty() const;
+    std::vector<std::pair<TKey, TValue>> to_vector() const;
+
+    // visit() - Calls visitor(const TValue &) under the read lock if key is present,
+    // avoiding a copy of the value; returns whether it was found
+    template <typename Visitor>
+    bool visit(const TKey &key, Visitor &&visitor) const;
+
+    // update() - Calls updater(TValue &) under the write lock if key is present
+    template <typename Updater>
+    bool update(const TKey &key, Updater &&updater);
+};
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef MAPPED_TREE_CPP
+#define MAPPED_TREE_CPP
+
+#include "MappedTree.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+inline constexpr char MAPPED_TREE_MAGIC[8] = {'M', 'A', 'P', 'T', 'R', 'E', 'E', '1'};
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTree<TKey, TValue, Compare>::Writer::Writer(const std::string &path, const Compare &comparator)
+    : ComparatorStorage<Compare>(comparator), _out(path, std::ios::binary | std::ios::trunc), _path(path),
+      _block(BLOCK_BYTES, 0), _count(0), _in_block(0), _finished(false)
+{
+    if (!_out)
+        throw std::runtime_error("cannot create snapshot file " + path);
+
+    // Placeholder for the header, which finish() fills in
+    std::vector<char> header_page(PAGE_BYTES, 0);
+    _out.write(header_page.data(), header_page.size());
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void MappedTree<TKey, TValue, Compare>::Writer::append(const TKey &key, const TValue &value)
+{
+    if (_finished)
+        throw std::runtime_error("snapshot file " + _path + " is already finished");
+    if (_last && !this->comparator()(*_last, key))
+        throw std::invalid_argument("snapshot keys must be strictly ascending");
+    _last = key;
+
+    if (_in_block == 0)
+        _index.push_back(key);
+    std::memcpy(&_block[_in_block * sizeof(TKey)], &key, sizeof(TKey));
+    if constexpr (VALUE_BYTES > 0)
+        std::memcpy(&_block[KEY_BYTES + _in_block * sizeof(TValue)], &value, sizeof(TValue));
+    _in_block++;
+    _count++;
+
+    if (_in_block == BLOCK_ENTRIES)
+        flush_block();
+}
+
+// flush_block() - Writes the buffered block, padded to full size
+template <typename TKey, typename TValue, typename Compare>
+void MappedTree<TKey, TValue, Compare>::Writer::flush_block()
+{
+    _out.write(_block.data(), _block.size());
+    if (!_out)
+        throw std::runtime_error("cannot write snapshot file " + _path);
+    std::fill(_block.begin(), _block.end(), 0);
+    _in_block = 0;
+}
+
+// finish() - Writes the last block, the sparse index and finally the header
+template <typename TKey, typename TValue, typename Compare>
+void MappedTree<TKey, TValue, Compare>::Writer::finish()
+{
+    if (_finished)
+        return;
+    if (_in_block > 0)
+        flush_block();
+
+    _out.write(reinterpret_cast<const char *>(_index.data()), _index.size() * sizeof(TKey));
+
+    MappedTreeHeader header{};
+    std::memcpy(header.magic, MAPPED_TREE_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.key_size = sizeof(TKey);
+    header.value_size = VALUE_BYTES > 0 ? sizeof(TValue) : 0;
+    header.block_entries = BLOCK_ENTRIES;
+    header.count = _count;
+    header.block_count = _index.size();
+    header.block_bytes = BLOCK_BYTES;
+    header.data_offset = PAGE_BYTES;
+    header.index_offset = PAGE_BYTES + _index.size() * BLOCK_BYTES;
+
+    _out.seekp(0);
+    _out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    _out.close();
+    if (!_out)
+        throw std::runtime_error("cannot write snapshot file " + _path);
+    _finished = true;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTree<TKey, TValue, Compare>::MappedTree(const std::string &path, const Compare &comparator)
+    : ComparatorStorage<Compare>(comparator), _data(nullptr), _length(0), _header(nullptr), _index(nullptr)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open snapshot file " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < PAGE_BYTES)
+    {
+        ::close(fd);
+        throw std::runtime_error("snapshot file " + path + " is truncated");
+    }
+
+    _length = static_cast<size_t>(info.st_size);
+    void *data = ::mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file open
+    if (data == MAP_FAILED)
+        throw std::runtime_error("cannot map snapshot file " + path);
+    _data = static_cast<const char *>(data);
+    _header = reinterpret_cast<const MappedTreeHeader *>(_data);
+
+    const MappedTreeHeader &header = *_header;
+    size_t value_size = VALUE_BYTES > 0 ? sizeof(TValue) : 0;
+    bool valid = std::memcmp(header.magic, MAPPED_TREE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == FORMAT_VERSION && header.key_size == sizeof(TKey) &&
+                 header.value_size == value_size && header.block_entries == BLOCK_ENTRIES &&
+                 header.block_bytes == BLOCK_BYTES && header.data_offset == PAGE_BYTES &&
+                 header.block_count == (header.count + BLOCK_ENTRIES - 1) / BLOCK_ENTRIES &&
+                 header.index_offset == PAGE_BYTES + header.block_count * BLOCK_BYTES &&
+                 header.index_offset + header.block_count * sizeof(TKey) <= _length;
+    if (!valid)
+    {
+        unmap();
+        throw std::runtime_error("snapshot file " + path + " is malformed or holds other key/value types");
+    }
+    _index = reinterpret_cast<const TKey *>(_data + header.index_offset);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTree<TKey, TValue, Compare>::MappedTree(MappedTree &&other) noexcept(
+    std::is_nothrow_copy_constructible_v<Compare>)
+    : ComparatorStorage<Compare>(other.comparator()), _data(std::exchange(other._data, nullptr)),
+      _length(std::exchange(other._length, 0)), _header(std::exchange(other._header, nullptr)),
+      _index(std::exchange(other._index, nullptr)) {}
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTree<TKey, TValue, Compare> &MappedTree<TKey, TValue, Compare>::operator=(MappedTree &&other) noexcept(
+    std::is_nothrow_copy_assignable_v<Compare>)
+{
+    if (this != &other)
+    {
+        // The comparator goes first so a throwing copy leaves this snapshot mapped
+        ComparatorStorage<Compare>::operator=(other);
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _length = std::exchange(other._length, 0);
+        _header = std::exchange(other._header, nullptr);
+        _index = std::exchange(other._index, nullptr);
+    }
+    return *this;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTree<TKey, TValue, Compare>::~MappedTree()
+{
+    unmap();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void MappedTree<TKey, TValue, Compare>::unmap()
+{
+    if (_data != nullptr)
+        ::munmap(const_cast<char *>(_data), _length);
+    _data = nullptr;
+    _header = nullptr;
+    _index = nullptr;
+    _length = 0;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TKey *MappedTree<TKey, TValue, Compare>::block_keys(size_t block) const
+{
+    return reinterpret_cast<const TKey *>(_data + PAGE_BYTES + block * BLOCK_BYTES);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TKey &MappedTree<TKey, TValue, Compare>::key_at(size_t position) const
+{
+    return block_keys(position / BLOCK_ENTRIES)[position % BLOCK_ENTRIES];
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TValue &MappedTree<TKey, TValue, Compare>::value_at(size_t position) const
+{
+    if constexpr (VALUE_BYTES == 0)
+    {
+        return empty_value;
+    }
+    else
+    {
+        const char *block = _data + PAGE_BYTES + (position / BLOCK_ENTRIES) * BLOCK_BYTES;
+        return reinterpret_cast<const TValue *>(block + KEY_BYTES)[position % BLOCK_ENTRIES];
+    }
+}
+
+// lower_index() - Position of the first key not ordered before key. The
+// index narrows the search to the last block starting below key; if key is
+// above that whole block the answer is the start of the next one.
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+size_t MappedTree<TKey, TValue, Compare>::lower_index(const K &key) const
+{
+    size_t blocks = _header->block_count;
+    const TKey *after = std::lower_bound(_index, _index + blocks, key, [&](const TKey &entry, const K &probe)
+                                         { return comparator()(entry, probe); });
+    if (after == _index)
+        return 0;
+
+    size_t block = static_cast<size_t>(after - _index) - 1;
+    size_t entries = std::min<size_t>(BLOCK_ENTRIES, _header->count - block * BLOCK_ENTRIES);
+    const TKey *keys = block_keys(block);
+    const TKey *found = std::lower_bound(keys, keys + entries, key, [&](const TKey &entry, const K &probe)
+                                         { return comparator()(entry, probe); });
+    return block * BLOCK_ENTRIES + static_cast<size_t>(found - keys);
+}
+
+// upper_index() - Position of the first key ordered after key
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+size_t MappedTree<TKey, TValue, Compare>::upper_index(const K &key) const
+{
+    size_t blocks = _header->block_count;
+    const TKey *after = std::upper_bound(_index, _index + blocks, key, [&](const K &probe, const TKey &entry)
+                                         { return comparator()(probe, entry); });
+    if (after == _index)
+        return 0;
+
+    size_t block = static_cast<size_t>(after - _index) - 1;
+    size_t entries = std::min<size_t>(BLOCK_ENTRIES, _header->count - block * BLOCK_ENTRIES);
+    const TKey *keys = block_keys(block);
+    const TKey *found = std::upper_bound(keys, keys + entries, key, [&](const K &probe, const TKey &entry)
+                                         { return comparator()(probe, entry); });
+    return block * BLOCK_ENTRIES + static_cast<size_t>(found - keys);
+}
+
+// find_index() - Position of the entry equivalent to key, or size() if there is none
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+size_t MappedTree<TKey, TValue, Compare>::find_index(const K &key) const
+{
+    size_t position = lower_index(key);
+    if (position < _header->count && !comparator()(key, key_at(position)))
+        return position;
+    return _header->count;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+size_t MappedTree<TKey, TValue, Compare>::size() const
+{
+    return _header->count;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool MappedTree<TKey, TValue, Compare>::is_empty() const
+{
+    return _header->count == 0;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename MappedTree<TKey, TValue, Compare>::const_iterator MappedTree<TKey, TValue, Compare>::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename MappedTree<TKey, TValue, Compare>::const_iterator MappedTree<TKey, TValue, Compare>::end() const
+{
+    return const_iterator(this, _header->count);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+typename MappedTree<TKey, TValue, Compare>::const_iterator MappedTree<TKey, TValue, Compare>::lower_bound(
+    const K &key) const
+{
+    return const_iterator(this, lower_index(key));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+typename MappedTree<TKey, TValue, Compare>::const_iterator MappedTree<TKey, TValue, Compare>::upper_bound(
+    const K &key) const
+{
+    return const_iterator(this, upper_index(key));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K>
+std::pair<typename MappedTree<TKey, TValue, Compare>::const_iterator,
+          typename MappedTree<TKey, TValue, Compare>::const_iterator>
+MappedTree<TKey, TValue, Compare>::range(const K &lo, const K &hi) const
+{
+    size_t first = lower_index(lo);
+    size_t last = std::max(first, lower_index(hi));
+    return {const_iterator(this, first), const_iterator(this, last)};
+}
+
+#endif
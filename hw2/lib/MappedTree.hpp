@@ -0,0 +1,212 @@
+#ifndef MAPPED_TREE_HPP
+#define MAPPED_TREE_HPP
+
+#include "TreeSet.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Value type of a mapped tree used as a set; no value bytes are stored.
+struct MappedNoValue
+{
+};
+
+// Fixed-size header at the start of every snapshot file. The header is
+// padded to one page, so the data blocks that follow are page aligned.
+struct MappedTreeHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t block_entries;
+    uint64_t count;
+    uint64_t block_count;
+    uint64_t block_bytes;
+    uint64_t data_offset;
+    uint64_t index_offset;
+};
+
+// Read-only ordered tree backed by a memory-mapped snapshot file, the core
+// of MappedTreeSet and MappedTreeMap. The file holds sorted entries in
+// fixed-size blocks (one page of keys, then the matching values), followed
+// by a sparse index holding the first key of every block:
+//
+//   [header, padded to 4 KiB][block 0][block 1]...[block n-1][index]
+//
+// A lookup binary searches the small index, then the keys of one block, so
+// it touches a couple of pages; the kernel loads pages on first use and
+// opening a snapshot costs one mmap() regardless of its size. Keys and
+// values must be trivially copyable, and the file is only valid for the
+// same key and value types and the same ordering it was written with.
+// Failures to open, write or validate a file throw std::runtime_error.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class MappedTree : private ComparatorStorage<Compare>
+{
+    static_assert(std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>,
+                  "mapped trees store raw bytes of trivially copyable keys and values");
+    static_assert(alignof(TKey) <= 64 && alignof(TValue) <= 64, "entries are aligned to at most 64 bytes");
+
+protected:
+    static constexpr bool IS_SET = std::is_same_v<TValue, MappedNoValue>;
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr size_t PAGE_BYTES = 4096;
+    static constexpr size_t BLOCK_ENTRIES = PAGE_BYTES / sizeof(TKey) < 16 ? 16 : PAGE_BYTES / sizeof(TKey);
+    static constexpr size_t KEY_BYTES = (BLOCK_ENTRIES * sizeof(TKey) + 63) / 64 * 64;
+    static constexpr size_t VALUE_BYTES = std::is_empty_v<TValue> ? 0 : (BLOCK_ENTRIES * sizeof(TValue) + 63) / 64 * 64;
+    static constexpr size_t BLOCK_BYTES = KEY_BYTES + VALUE_BYTES;
+
+    const char *_data;
+    size_t _length;
+    const MappedTreeHeader *_header;
+    const TKey *_index;
+
+    using ComparatorStorage<Compare>::comparator;
+
+    static inline const TValue empty_value{};
+
+    const TKey *block_keys(size_t block) const;
+    const TKey &key_at(size_t position) const;
+    const TValue &value_at(size_t position) const;
+    template <typename K>
+    size_t lower_index(const K &key) const;
+    template <typename K>
+    size_t upper_index(const K &key) const;
+    template <typename K>
+    size_t find_index(const K &key) const;
+    void unmap();
+
+public:
+    using value_type = std::conditional_t<IS_SET, TKey, std::pair<TKey, TValue>>;
+    using reference = std::conditional_t<IS_SET, const TKey &, std::pair<const TKey &, const TValue &>>;
+
+    // Streams strictly ascending entries into a new snapshot file in one
+    // pass, holding only one block in memory. The file only becomes valid
+    // once finish() has written the index and header.
+    class Writer : private ComparatorStorage<Compare>
+    {
+    private:
+        std::ofstream _out;
+        std::string _path;
+        std::vector<char> _block;
+        std::vector<TKey> _index;
+        std::optional<TKey> _last;
+        size_t _count;
+        size_t _in_block;
+        bool _finished;
+
+        void flush_block();
+
+    public:
+        explicit Writer(const std::string &path, const Compare &comparator = Compare());
+
+        // append() - Adds the next entry; throws std::invalid_argument if key is not above the last one
+        void append(const TKey &key, const TValue &value = TValue());
+        void finish();
+    };
+
+    // Position in the sorted entries; references point straight into the mapping
+    class const_iterator
+    {
+    private:
+        friend class MappedTree;
+
+        const MappedTree *_tree;
+        size_t _position;
+
+        const_iterator(const MappedTree *tree, size_t position) : _tree(tree), _position(position) {}
+
+        struct ArrowProxy
+        {
+            std::pair<const TKey &, const TValue &> entry;
+            const std::pair<const TKey &, const TValue &> *operator->() const { return &entry; }
+        };
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = MappedTree::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = MappedTree::reference;
+        using pointer = std::conditional_t<IS_SET, const TKey *, ArrowProxy>;
+
+        const_iterator() : _tree(nullptr), _position(0) {}
+
+        const TKey &key() const { return _tree->key_at(_position); }
+        const TValue &value() const { return _tree->value_at(_position); }
+
+        reference operator*() const
+        {
+            if constexpr (IS_SET)
+                return key();
+            else
+                return {key(), value()};
+        }
+        pointer operator->() const
+        {
+            if constexpr (IS_SET)
+                return &key();
+            else
+                return ArrowProxy{{key(), value()}};
+        }
+
+        const_iterator &operator++()
+        {
+            ++_position;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        const_iterator &operator--()
+        {
+            --_position;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const { return _position == other._position; }
+        bool operator!=(const const_iterator &other) const { return _position != other._position; }
+    };
+
+    using iterator = const_iterator;
+
+    // Maps the snapshot at path read-only; throws std::runtime_error if it is missing or malformed
+    explicit MappedTree(const std::string &path, const Compare &comparator = Compare());
+    MappedTree(const MappedTree &) = delete;
+    MappedTree &operator=(const MappedTree &) = delete;
+    // Moves hand over the mapping, leaving other unmapped
+    MappedTree(MappedTree &&other) noexcept(std::is_nothrow_copy_constructible_v<Compare>);
+    MappedTree &operator=(MappedTree &&other) noexcept(std::is_nothrow_copy_assignable_v<Compare>);
+    ~MappedTree();
+
+    size_t size() const;
+    bool is_empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    template <typename K>
+    const_iterator lower_bound(const K &key) const;
+    template <typename K>
+    const_iterator upper_bound(const K &key) const;
+    // range() - Iterators bounding the entries with keys in [lo, hi)
+    template <typename K>
+    std::pair<const_iterator, const_iterator> range(const K &lo, const K &hi) const;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef MAPPED_TREE_MAP_CPP
+#define MAPPED_TREE_MAP_CPP
+
+#include "MappedTreeMap.hpp"
+#include "MappedTree.cpp"
+#include "TreeMap.cpp"
+
+template <typename TKey, typename TValue, typename Compare>
+MappedTreeMap<TKey, TValue, Compare>::MappedTreeMap(const std::string &path, const Compare &comparator)
+    : Base(path, comparator) {}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename InputIt>
+void MappedTreeMap<TKey, TValue, Compare>::write(const std::string &path, InputIt first, InputIt last,
+                                                 const Compare &comparator)
+{
+    Writer writer(path, comparator);
+    for (; first != last; ++first)
+        writer.append(first->first, first->second);
+    writer.finish();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void MappedTreeMap<TKey, TValue, Compare>::write(const std::string &path, const TreeMap<TKey, TValue, Compare> &map)
+{
+    write(path, map.begin(), map.end(), map.key_comp());
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::optional<TValue> MappedTreeMap<TKey, TValue, Compare>::get(const TKey &key) const
+{
+    const TValue *value = find(key);
+
+    if (value)
+    {
+        return *value;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool MappedTreeMap<TKey, TValue, Compare>::contains(const TKey &key) const
+{
+    return this->find_index(key) != this->size();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TValue *MappedTreeMap<TKey, TValue, Compare>::find(const TKey &key) const
+{
+    size_t position = this->find_index(key);
+    return position == this->size() ? nullptr : &this->value_at(position);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::pair<TKey, TValue>> MappedTreeMap<TKey, TValue, Compare>::to_vector() const
+{
+    std::vector<std::pair<TKey, TValue>> result;
+    result.reserve(this->size());
+    for (const_iterator it = this->begin(); it != this->end(); ++it)
+        result.emplace_back(it.key(), it.value());
+    return result;
+}
+
+#endif
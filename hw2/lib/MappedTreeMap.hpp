@@ -0,0 +1,41 @@
+#ifndef MAPPED_TREE_MAP_HPP
+#define MAPPED_TREE_MAP_HPP
+
+#include "MappedTree.hpp"
+#include "TreeMap.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Read-only TreeMap loaded from a snapshot file with mmap(). write() saves
+// a TreeMap (or any ascending sequence of pairs) in one pass; opening the
+// file later is O(1) and pages are read lazily as lookups touch them.
+// Iterators yield std::pair<const TKey &, const TValue &> proxies.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class MappedTreeMap : public MappedTree<TKey, TValue, Compare>
+{
+private:
+    using Base = MappedTree<TKey, TValue, Compare>;
+
+public:
+    using typename Base::const_iterator;
+    using typename Base::Writer;
+
+    explicit MappedTreeMap(const std::string &path, const Compare &comparator = Compare());
+
+    // write() - Saves entries with strictly ascending keys as a snapshot file
+    template <typename InputIt>
+    static void write(const std::string &path, InputIt first, InputIt last, const Compare &comparator = Compare());
+    static void write(const std::string &path, const TreeMap<TKey, TValue, Compare> &map);
+
+    std::optional<TValue> get(const TKey &key) const;
+    bool contains(const TKey &key) const;
+
+    // find() - Points at the value inside the mapping, or nullptr
+    const TValue *find(const TKey &key) const;
+    std::vector<std::pair<TKey, TValue>> to_vector() const;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef MAPPED_TREE_SET_CPP
+#define MAPPED_TREE_SET_CPP
+
+#include "MappedTreeSet.hpp"
+#include "MappedTree.cpp"
+#include "TreeSet.cpp"
+
+template <typename T, typename Compare>
+MappedTreeSet<T, Compare>::MappedTreeSet(const std::string &path, const Compare &comparator)
+    : Base(path, comparator) {}
+
+template <typename T, typename Compare>
+template <typename InputIt>
+void MappedTreeSet<T, Compare>::write(const std::string &path, InputIt first, InputIt last, const Compare &comparator)
+{
+    Writer writer(path, comparator);
+    for (; first != last; ++first)
+        writer.append(*first);
+    writer.finish();
+}
+
+template <typename T, typename Compare>
+template <typename Stats>
+void MappedTreeSet<T, Compare>::write(const std::string &path, const TreeSet<T, Compare, Stats> &set)
+{
+    write(path, set.begin(), set.end(), set.key_comp());
+}
+
+template <typename T, typename Compare>
+bool MappedTreeSet<T, Compare>::contains(const T &value) const
+{
+    return this->find_index(value) != this->size();
+}
+
+template <typename T, typename Compare>
+std::optional<T> MappedTreeSet<T, Compare>::get(const T &value) const
+{
+    size_t position = this->find_index(value);
+    return position == this->size() ? std::nullopt : std::optional<T>(this->key_at(position));
+}
+
+// min() - Finds the smallest value in the set
+template <typename T, typename Compare>
+std::optional<T> MappedTreeSet<T, Compare>::min() const
+{
+    return this->is_empty() ? std::nullopt : std::optional<T>(this->key_at(0));
+}
+
+// max() - Finds the largest value in the set
+template <typename T, typename Compare>
+std::optional<T> MappedTreeSet<T, Compare>::max() const
+{
+    return this->is_empty() ? std::nullopt : std::optional<T>(this->key_at(this->size() - 1));
+}
+
+template <typename T, typename Compare>
+std::vector<T> MappedTreeSet<T, Compare>::to_vector() const
+{
+    return std::vector<T>(this->begin(), this->end());
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MAPPED_TREE_SET_HPP
+#define MAPPED_TREE_SET_HPP
+
+#include "MappedTree.hpp"
+#include "TreeSet.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Read-only TreeSet loaded from a snapshot file with mmap(); see MappedTree
+// for the file layout.
+template <typename T, typename Compare = std::less<T>>
+class MappedTreeSet : public MappedTree<T, MappedNoValue, Compare>
+{
+private:
+    using Base = MappedTree<T, MappedNoValue, Compare>;
+
+public:
+    using typename Base::const_iterator;
+    using typename Base::Writer;
+
+    explicit MappedTreeSet(const std::string &path, const Compare &comparator = Compare());
+
+    // write() - Saves strictly ascending values as a snapshot file
+    template <typename InputIt>
+    static void write(const std::string &path, InputIt first, InputIt last, const Compare &comparator = Compare());
+    template <typename Stats>
+    static void write(const std::string &path, const TreeSet<T, Compare, Stats> &set);
+
+    bool contains(const T &value) const;
+    std::optional<T> get(const T &value) const;
+    std::optional<T> min() const;
+    std::optional<T> max() const;
+    std::vector<T> to_vector() const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef NODE_POOL_CPP
+#define NODE_POOL_CPP
+
+#include "NodePool.hpp"
+#include <new>
+#include <utility>
+
+template <typename Node>
+NodePool<Node>::NodePool(std::pmr::memory_resource *resource)
+    : _resource(resource), _slabs(nullptr), _free(nullptr), _cursor(nullptr), _cursor_end(nullptr),
+      _next_slab_slots(FIRST_SLAB_SLOTS) {}
+
+template <typename Node>
+NodePool<Node>::NodePool(NodePool &&other) noexcept
+    : _resource(other._resource), _slabs(other._slabs), _free(other._free), _cursor(other._cursor),
+      _cursor_end(other._cursor_end), _next_slab_slots(other._next_slab_slots)
+{
+    other._slabs = nullptr;
+    other._free = other._cursor = other._cursor_end = nullptr;
+    other._next_slab_slots = FIRST_SLAB_SLOTS;
+}
+
+template <typename Node>
+NodePool<Node> &NodePool<Node>::operator=(NodePool &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        _resource = other._resource;
+        _slabs = std::exchange(other._slabs, nullptr);
+        _free = std::exchange(other._free, nullptr);
+        _cursor = std::exchange(other._cursor, nullptr);
+        _cursor_end = std::exchange(other._cursor_end, nullptr);
+        _next_slab_slots = std::exchange(other._next_slab_slots, FIRST_SLAB_SLOTS);
+    }
+    return *this;
+}
+
+template <typename Node>
+NodePool<Node>::~NodePool()
+{
+    release();
+}
+
+// slots_offset() - Distance from the start of a slab to its first slot
+template <typename Node>
+size_t NodePool<Node>::slots_offset()
+{
+    return (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+}
+
+// grow() - Fetches a new slab from the memory resource, doubling the slab size up to a cap
+template <typename Node>
+void NodePool<Node>::grow()
+{
+    size_t bytes = slots_offset() + _next_slab_slots * sizeof(Slot);
+    constexpr size_t alignment = alignof(Slot) > alignof(Slab) ? alignof(Slot) : alignof(Slab);
+    void *memory = _resource->allocate(bytes, alignment);
+
+    Slab *slab = static_cast<Slab *>(memory);
+    slab->next = _slabs;
+    slab->bytes = bytes;
+    _slabs = slab;
+
+    _cursor = reinterpret_cast<Slot *>(static_cast<unsigned char *>(memory) + slots_offset());
+    _cursor_end = _cursor + _next_slab_slots;
+
+    if (_next_slab_slots < MAX_SLAB_SLOTS)
+        _next_slab_slots *= 2;
+}
+
+// create() - Constructs a node in a recycled slot, or the next fresh slot of the current slab
+template <typename Node>
+template <typename... Args>
+Node *NodePool<Node>::create(Args &&...args)
+{
+    Slot *slot;
+    if (_free != nullptr)
+    {
+        slot = _free;
+        _free = _free->next;
+    }
+    else
+    {
+        if (_cursor == _cursor_end)
+            grow();
+        slot = _cursor++;
+    }
+
+    try
+    {
+        return ::new (static_cast<void *>(slot->storage)) Node(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        slot->next = _free;
+        _free = slot;
+        throw;
+    }
+}
+
+// destroy() - Runs the node's destructor and puts its slot on the free list
+template <typename Node>
+void NodePool<Node>::destroy(Node *node)
+{
+    node->~Node();
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    slot->next = _free;
+    _free = slot;
+}
+
+// release() - Returns every slab to the memory resource; live nodes are not destroyed
+template <typename Node>
+void NodePool<Node>::release()
+{
+    while (_slabs != nullptr)
+    {
+        Slab *next = _slabs->next;
+        constexpr size_t alignment = alignof(Slot) > alignof(Slab) ? alignof(Slot) : alignof(Slab);
+        _resource->deallocate(_slabs, _slabs->bytes, alignment);
+        _slabs = next;
+    }
+    _free = _cursor = _cursor_end = nullptr;
+    _next_slab_slots = FIRST_SLAB_SLOTS;
+}
+
+template <typename Node>
+std::pmr::memory_resource *NodePool<Node>::resource() const
+{
+    return _resource;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// Slab allocator for fixed-size tree nodes. Slots are carved out of slabs
+// obtained from a std::pmr::memory_resource, destroyed nodes go onto a free
+// list for reuse, and release() hands every slab back in one pass.
+template <typename Node>
+class NodePool
+{
+private:
+    union Slot
+    {
+        Slot *next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct Slab
+    {
+        Slab *next;
+        size_t bytes;
+    };
+
+    static constexpr size_t FIRST_SLAB_SLOTS = 32;
+    static constexpr size_t MAX_SLAB_SLOTS = 4096;
+
+    std::pmr::memory_resource *_resource;
+    Slab *_slabs;
+    Slot *_free;
+    Slot *_cursor;
+    Slot *_cursor_end;
+    size_t _next_slab_slots;
+
+    static size_t slots_offset();
+    void grow();
+
+public:
+    explicit NodePool(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+    NodePool(NodePool &&other) noexcept;
+    NodePool &operator=(NodePool &&other) noexcept;
+    ~NodePool();
+
+    template <typename... Args>
+    Node *create(Args &&...args);
+    void destroy(Node *node);
+    void release();
+
+    std::pmr::memory_resource *resource() const;
+};
+
+#endif
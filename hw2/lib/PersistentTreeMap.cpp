@@ -0,0 +1,89 @@
+#ifndef PERSISTENT_TREE_MAP_CPP
+#define PERSISTENT_TREE_MAP_CPP
+
+#include "PersistentTreeMap.hpp"
+#include "PersistentTreeSet.cpp"
+#include "TreeMap.cpp"
+
+template <typename TKey, typename TValue, typename Compare>
+PersistentTreeMap<TKey, TValue, Compare>::PersistentTreeMap() : PersistentTreeMap(Compare()) {}
+
+// Constructor with a key comparator
+template <typename TKey, typename TValue, typename Compare>
+PersistentTreeMap<TKey, TValue, Compare>::PersistentTreeMap(const Compare &comparator)
+    : _tree(KeyCompare<TKey, TValue, Compare>(comparator)) {}
+
+// Constructor with a vector of items
+template <typename TKey, typename TValue, typename Compare>
+PersistentTreeMap<TKey, TValue, Compare>::PersistentTreeMap(const std::vector<std::pair<TKey, TValue>> &items)
+    : _tree(items) {}
+
+template <typename TKey, typename TValue, typename Compare>
+PersistentTreeMap<TKey, TValue, Compare> PersistentTreeMap<TKey, TValue, Compare>::snapshot() const
+{
+    return PersistentTreeMap(*this);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void PersistentTreeMap<TKey, TValue, Compare>::insert(TKey key, TValue value)
+{
+    _tree.add(std::make_pair(std::move(key), std::move(value)));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool PersistentTreeMap<TKey, TValue, Compare>::erase(const TKey &key)
+{
+    return _tree.remove(key);
+}
+
+// get() - Copies only the value out of the matching entry
+template <typename TKey, typename TValue, typename Compare>
+std::optional<TValue> PersistentTreeMap<TKey, TValue, Compare>::get(const TKey &key) const
+{
+    return _tree.get_projected(key, [](const std::pair<TKey, TValue> &entry) -> const TValue &
+                               { return entry.second; });
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool PersistentTreeMap<TKey, TValue, Compare>::contains(const TKey &key) const
+{
+    return _tree.contains(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename PersistentTreeMap<TKey, TValue, Compare>::const_iterator PersistentTreeMap<TKey, TValue, Compare>::begin() const
+{
+    return _tree.begin();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename PersistentTreeMap<TKey, TValue, Compare>::const_iterator PersistentTreeMap<TKey, TValue, Compare>::end() const
+{
+    return _tree.end();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+size_t PersistentTreeMap<TKey, TValue, Compare>::size() const
+{
+    return _tree.size();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool PersistentTreeMap<TKey, TValue, Compare>::is_empty() const
+{
+    return _tree.is_empty();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::pair<TKey, TValue>> PersistentTreeMap<TKey, TValue, Compare>::to_vector() const
+{
+    return _tree.to_vector();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void PersistentTreeMap<TKey, TValue, Compare>::clear()
+{
+    _tree.clear();
+}
+
+#endif
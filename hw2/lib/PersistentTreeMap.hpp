@@ -0,0 +1,48 @@
+#ifndef PERSISTENT_TREE_MAP_HPP
+#define PERSISTENT_TREE_MAP_HPP
+
+#include "PersistentTreeSet.hpp"
+#include "TreeMap.hpp"
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Map counterpart of PersistentTreeSet: insert() and erase() path-copy
+// O(log n) nodes, and snapshot() hands out a stable point-in-time view in
+// O(1) that later writes never disturb.
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class PersistentTreeMap
+{
+private:
+    using Tree = PersistentTreeSet<std::pair<TKey, TValue>, KeyCompare<TKey, TValue, Compare>>;
+
+    Tree _tree;
+
+public:
+    using const_iterator = typename Tree::const_iterator;
+    using iterator = const_iterator;
+
+    PersistentTreeMap();
+    explicit PersistentTreeMap(const Compare &comparator);
+    PersistentTreeMap(const std::vector<std::pair<TKey, TValue>> &items);
+
+    // snapshot() - Returns an O(1) frozen copy of the current version
+    PersistentTreeMap snapshot() const;
+
+    void insert(TKey key, TValue value);
+    bool erase(const TKey &key);
+    std::optional<TValue> get(const TKey &key) const;
+    bool contains(const TKey &key) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    size_t size() const;
+    bool is_empty() const;
+    std::vector<std::pair<TKey, TValue>> to_vector() const;
+    void clear();
+};
+
+#endif
@@ -0,0 +1,454 @@
+#ifndef PERSISTENT_TREE_SET_CPP
+#define PERSISTENT_TREE_SET_CPP
+
+#include "PersistentTreeSet.hpp"
+#include "TreeSet.cpp"
+#include <atomic>
+
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare>::PersistentTreeSet() : PersistentTreeSet(Compare()) {}
+
+// Constructor with a custom comparator
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare>::PersistentTreeSet(const Compare &comparator)
+    : ComparatorStorage<Compare>(comparator), _version(std::make_shared<const Version>(Version{nullptr, 0})) {}
+
+// Constructor with a vector of items; builds one version instead of publishing one per item
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare>::PersistentTreeSet(const std::vector<T> &items, const Compare &comparator)
+    : ComparatorStorage<Compare>(comparator)
+{
+    Version version{nullptr, 0};
+    for (const T &item : items)
+    {
+        bool added = false;
+        version._root = blacken(insert_node(version._root, item, added));
+        version._size += added ? 1 : 0;
+    }
+    _version = std::make_shared<const Version>(std::move(version));
+}
+
+// Copy constructor; shares every node with other
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare>::PersistentTreeSet(const PersistentTreeSet &other)
+    : ComparatorStorage<Compare>(other), _version(other.load()) {}
+
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare> &PersistentTreeSet<T, Compare>::operator=(const PersistentTreeSet &other)
+{
+    if (this != &other)
+    {
+        static_cast<ComparatorStorage<Compare> &>(*this) = other;
+        std::atomic_store(&_version, other.load());
+    }
+    return *this;
+}
+
+template <typename T, typename Compare>
+PersistentTreeSet<T, Compare> PersistentTreeSet<T, Compare>::snapshot() const
+{
+    return PersistentTreeSet(*this);
+}
+
+// load() - Reads the current version; readers work on it without further synchronization
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::VersionPtr PersistentTreeSet<T, Compare>::load() const
+{
+    return std::atomic_load(&_version);
+}
+
+// commit() - Applies edit to a copy of the current version and publishes it,
+// redoing the edit on the newer version if another writer published first
+template <typename T, typename Compare>
+template <typename Edit>
+bool PersistentTreeSet<T, Compare>::commit(Edit edit)
+{
+    VersionPtr current = load();
+    while (true)
+    {
+        Version next = *current;
+        bool result = edit(next);
+        if (next._root == current->_root)
+            return result;
+
+        VersionPtr desired = std::make_shared<const Version>(std::move(next));
+        if (std::atomic_compare_exchange_weak(&_version, &current, desired))
+            return result;
+    }
+}
+
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::add(const T &value)
+{
+    return commit([&](Version &version)
+                  {
+        bool added = false;
+        version._root = blacken(insert_node(version._root, value, added));
+        version._size += added ? 1 : 0;
+        return added; });
+}
+
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::remove(const T &value)
+{
+    return commit([&](Version &version)
+                  {
+        if (find_node(version._root.get(), value) == nullptr)
+            return false;
+        version._root = blacken(erase_node(version._root, value));
+        version._size--;
+        return true; });
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+bool PersistentTreeSet<T, Compare>::remove(const K &key)
+{
+    return commit([&](Version &version)
+                  {
+        if (find_node(version._root.get(), key) == nullptr)
+            return false;
+        version._root = blacken(erase_node(version._root, key));
+        version._size--;
+        return true; });
+}
+
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::make(Color color, NodePtr left,
+                                                                                 const T &value, NodePtr right)
+{
+    return std::make_shared<const Node>(color, std::move(left), value, std::move(right));
+}
+
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::is_red(const NodePtr &node)
+{
+    return node != nullptr && node->_color == Red;
+}
+
+// is_black() - True for a black node; empty subtrees do not count
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::is_black(const NodePtr &node)
+{
+    return node != nullptr && node->_color == Black;
+}
+
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::blacken(const NodePtr &node)
+{
+    if (!is_red(node))
+        return node;
+    return make(Black, node->_left, node->value, node->_right);
+}
+
+// redden() - Recolors a black node red, lowering its black height by one
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::redden(const NodePtr &node)
+{
+    return make(Red, node->_left, node->value, node->_right);
+}
+
+// balance() - Builds a black node over left and right, rotating away a red
+// child with a red child of its own (Okasaki's four cases, plus a color flip
+// when both children are red)
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::balance(const NodePtr &left,
+                                                                                    const T &value,
+                                                                                    const NodePtr &right)
+{
+    if (is_red(left) && is_red(right))
+        return make(Red, blacken(left), value, blacken(right));
+    if (is_red(left) && is_red(left->_left))
+        return make(Red, blacken(left->_left), left->value, make(Black, left->_right, value, right));
+    if (is_red(left) && is_red(left->_right))
+    {
+        const NodePtr &middle = left->_right;
+        return make(Red, make(Black, left->_left, left->value, middle->_left), middle->value,
+                    make(Black, middle->_right, value, right));
+    }
+    if (is_red(right) && is_red(right->_right))
+        return make(Red, make(Black, left, value, right->_left), right->value, blacken(right->_right));
+    if (is_red(right) && is_red(right->_left))
+    {
+        const NodePtr &middle = right->_left;
+        return make(Red, make(Black, left, value, middle->_left), middle->value,
+                    make(Black, middle->_right, right->value, right->_right));
+    }
+    return make(Black, left, value, right);
+}
+
+// balance_left() - Rebuilds a node whose left subtree lost one black level
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::balance_left(const NodePtr &left,
+                                                                                         const T &value,
+                                                                                         const NodePtr &right)
+{
+    if (is_red(left))
+        return make(Red, blacken(left), value, right);
+    if (is_black(right))
+        return balance(left, value, redden(right));
+
+    const NodePtr &middle = right->_left;
+    return make(Red, make(Black, left, value, middle->_left), middle->value,
+                balance(middle->_right, right->value, redden(right->_right)));
+}
+
+// balance_right() - Rebuilds a node whose right subtree lost one black level
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::balance_right(const NodePtr &left,
+                                                                                          const T &value,
+                                                                                          const NodePtr &right)
+{
+    if (is_red(right))
+        return make(Red, left, value, blacken(right));
+    if (is_black(left))
+        return balance(redden(left), value, right);
+
+    const NodePtr &middle = left->_right;
+    return make(Red, balance(redden(left->_left), left->value, middle->_left), middle->value,
+                make(Black, middle->_right, value, right));
+}
+
+// join() - Merges the two subtrees of a removed node, every value in left
+// ordering before every value in right
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::join(const NodePtr &left,
+                                                                                 const NodePtr &right)
+{
+    if (left == nullptr)
+        return right;
+    if (right == nullptr)
+        return left;
+
+    if (is_red(left) && is_red(right))
+    {
+        NodePtr inner = join(left->_right, right->_left);
+        if (is_red(inner))
+            return make(Red, make(Red, left->_left, left->value, inner->_left), inner->value,
+                        make(Red, inner->_right, right->value, right->_right));
+        return make(Red, left->_left, left->value, make(Red, inner, right->value, right->_right));
+    }
+    if (is_black(left) && is_black(right))
+    {
+        NodePtr inner = join(left->_right, right->_left);
+        if (is_red(inner))
+            return make(Red, make(Black, left->_left, left->value, inner->_left), inner->value,
+                        make(Black, inner->_right, right->value, right->_right));
+        return balance_left(left->_left, left->value, make(Black, inner, right->value, right->_right));
+    }
+    if (is_red(right))
+        return make(Red, join(left, right->_left), right->value, right->_right);
+    return make(Red, left->_left, left->value, join(left->_right, right));
+}
+
+// insert_node() - Returns a copy of the subtree with value added; only the search path is copied
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::insert_node(const NodePtr &node,
+                                                                                        const T &value,
+                                                                                        bool &added) const
+{
+    if (node == nullptr)
+    {
+        added = true;
+        return make(Red, nullptr, value, nullptr);
+    }
+
+    if (this->comparator()(value, node->value))
+    {
+        NodePtr left = insert_node(node->_left, value, added);
+        return node->_color == Black ? balance(left, node->value, node->_right)
+                                     : make(Red, std::move(left), node->value, node->_right);
+    }
+    if (this->comparator()(node->value, value))
+    {
+        NodePtr right = insert_node(node->_right, value, added);
+        return node->_color == Black ? balance(node->_left, node->value, right)
+                                     : make(Red, node->_left, node->value, std::move(right));
+    }
+
+    // Equal value: replace it, keeping shape and color
+    added = false;
+    return make(node->_color, node->_left, value, node->_right);
+}
+
+// erase_node() - Returns a copy of the subtree without key (Kahrs' deletion)
+template <typename T, typename Compare>
+template <typename K>
+typename PersistentTreeSet<T, Compare>::NodePtr PersistentTreeSet<T, Compare>::erase_node(const NodePtr &node,
+                                                                                       const K &key) const
+{
+    if (node == nullptr)
+        return nullptr;
+
+    if (this->comparator()(key, node->value))
+    {
+        NodePtr left = erase_node(node->_left, key);
+        return is_black(node->_left) ? balance_left(left, node->value, node->_right)
+                                     : make(Red, std::move(left), node->value, node->_right);
+    }
+    if (this->comparator()(node->value, key))
+    {
+        NodePtr right = erase_node(node->_right, key);
+        return is_black(node->_right) ? balance_right(node->_left, node->value, right)
+                                      : make(Red, node->_left, node->value, std::move(right));
+    }
+
+    return join(node->_left, node->_right);
+}
+
+template <typename T, typename Compare>
+template <typename K>
+const typename PersistentTreeSet<T, Compare>::Node *PersistentTreeSet<T, Compare>::find_node(const Node *root,
+                                                                                          const K &key) const
+{
+    const Node *current = root;
+    while (current != nullptr)
+    {
+        if (this->comparator()(key, current->value))
+            current = current->_left.get();
+        else if (this->comparator()(current->value, key))
+            current = current->_right.get();
+        else
+            return current;
+    }
+    return nullptr;
+}
+
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::contains(const T &value) const
+{
+    return find_node(load()->_root.get(), value) != nullptr;
+}
+
+// get() - Returns a copy of the stored value equal to value, if any
+template <typename T, typename Compare>
+std::optional<T> PersistentTreeSet<T, Compare>::get(const T &value) const
+{
+    VersionPtr version = load();
+    const Node *node = find_node(version->_root.get(), value);
+    return node == nullptr ? std::nullopt : std::optional<T>(node->value);
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+bool PersistentTreeSet<T, Compare>::contains(const K &key) const
+{
+    return find_node(load()->_root.get(), key) != nullptr;
+}
+
+template <typename T, typename Compare>
+template <typename K, typename C, typename>
+std::optional<T> PersistentTreeSet<T, Compare>::get(const K &key) const
+{
+    VersionPtr version = load();
+    const Node *node = find_node(version->_root.get(), key);
+    return node == nullptr ? std::nullopt : std::optional<T>(node->value);
+}
+
+template <typename T, typename Compare>
+template <typename K, typename Project>
+auto PersistentTreeSet<T, Compare>::get_projected(const K &key, Project project) const
+    -> std::optional<std::decay_t<std::invoke_result_t<Project, const T &>>>
+{
+    VersionPtr version = load();
+    const Node *node = find_node(version->_root.get(), key);
+    if (node == nullptr)
+        return std::nullopt;
+    return project(node->value);
+}
+
+// min() - Finds the smallest value in the set
+template <typename T, typename Compare>
+std::optional<T> PersistentTreeSet<T, Compare>::min() const
+{
+    VersionPtr version = load();
+    const Node *current = version->_root.get();
+    if (current == nullptr)
+        return std::nullopt;
+    while (current->_left != nullptr)
+        current = current->_left.get();
+    return current->value;
+}
+
+// max() - Finds the largest value in the set
+template <typename T, typename Compare>
+std::optional<T> PersistentTreeSet<T, Compare>::max() const
+{
+    VersionPtr version = load();
+    const Node *current = version->_root.get();
+    if (current == nullptr)
+        return std::nullopt;
+    while (current->_right != nullptr)
+        current = current->_right.get();
+    return current->value;
+}
+
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::const_iterator PersistentTreeSet<T, Compare>::begin() const
+{
+    return const_iterator(load());
+}
+
+template <typename T, typename Compare>
+typename PersistentTreeSet<T, Compare>::const_iterator PersistentTreeSet<T, Compare>::end() const
+{
+    return const_iterator();
+}
+
+template <typename T, typename Compare>
+size_t PersistentTreeSet<T, Compare>::size() const
+{
+    return load()->_size;
+}
+
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::is_empty() const
+{
+    return size() == 0;
+}
+
+// is_balanced() - Checks the red-black invariants: black root, no red-red edge, equal black height
+template <typename T, typename Compare>
+bool PersistentTreeSet<T, Compare>::is_balanced() const
+{
+    VersionPtr version = load();
+    if (is_red(version->_root))
+        return false;
+    return black_height(version->_root.get()) != -1;
+}
+
+// black_height() - Returns the black height of a subtree, or -1 if it breaks an invariant
+template <typename T, typename Compare>
+int PersistentTreeSet<T, Compare>::black_height(const Node *node)
+{
+    if (node == nullptr)
+        return 1;
+    if (node->_color == Red && (is_red(node->_left) || is_red(node->_right)))
+        return -1;
+
+    int left = black_height(node->_left.get());
+    int right = black_height(node->_right.get());
+    if (left == -1 || right == -1 || left != right)
+        return -1;
+    return left + (node->_color == Black ? 1 : 0);
+}
+
+template <typename T, typename Compare>
+std::vector<T> PersistentTreeSet<T, Compare>::to_vector() const
+{
+    VersionPtr version = load();
+    std::vector<T> result;
+    result.reserve(version->_size);
+    for (const_iterator it(version); it != end(); ++it)
+        result.push_back(*it);
+    return result;
+}
+
+// clear() - Publishes an empty version; snapshots keep their nodes
+template <typename T, typename Compare>
+void PersistentTreeSet<T, Compare>::clear()
+{
+    std::atomic_store(&_version, std::make_shared<const Version>(Version{nullptr, 0}));
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef PERSISTENT_TREE_SET_HPP
+#define PERSISTENT_TREE_SET_HPP
+
+#include "BinaryTreeNode.hpp"
+#include "TreeSet.hpp"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Immutable red-black tree with structural sharing. Nodes are never changed
+// once built: add() and remove() copy only the O(log n) nodes on the search
+// path and share every other subtree with the previous version. Nodes are
+// reference counted, so a version lives exactly as long as some set,
+// snapshot or iterator still holds it.
+//
+// snapshot() and copying are O(1). The current version is published with
+// an atomic shared_ptr swap, so any number of threads may take snapshots or
+// read while others write; concurrent writers retry on conflict.
+template <typename T, typename Compare = std::less<T>>
+class PersistentTreeSet : private ComparatorStorage<Compare>
+{
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        T value;
+        NodePtr _left;
+        NodePtr _right;
+        Color _color;
+
+        Node(Color color, NodePtr left, T value, NodePtr right)
+            : value(std::move(value)), _left(std::move(left)), _right(std::move(right)), _color(color) {}
+    };
+
+    // One published state of the set: its root and element count
+    struct Version
+    {
+        NodePtr _root;
+        size_t _size;
+    };
+    using VersionPtr = std::shared_ptr<const Version>;
+
+    VersionPtr _version;
+
+    VersionPtr load() const;
+    template <typename Edit>
+    bool commit(Edit edit);
+
+    static NodePtr make(Color color, NodePtr left, const T &value, NodePtr right);
+    static bool is_red(const NodePtr &node);
+    static bool is_black(const NodePtr &node);
+    static NodePtr blacken(const NodePtr &node);
+    static NodePtr redden(const NodePtr &node);
+    static NodePtr balance(const NodePtr &left, const T &value, const NodePtr &right);
+    static NodePtr balance_left(const NodePtr &left, const T &value, const NodePtr &right);
+    static NodePtr balance_right(const NodePtr &left, const T &value, const NodePtr &right);
+    static NodePtr join(const NodePtr &left, const NodePtr &right);
+    static int black_height(const Node *node);
+
+    NodePtr insert_node(const NodePtr &node, const T &value, bool &added) const;
+    template <typename K>
+    NodePtr erase_node(const NodePtr &node, const K &key) const;
+    template <typename K>
+    const Node *find_node(const Node *root, const K &key) const;
+
+public:
+    // Forward iterator over one version; it keeps that version alive, so
+    // iterating is unaffected by writes made after begin()
+    class const_iterator
+    {
+    private:
+        friend class PersistentTreeSet;
+
+        VersionPtr _version;
+        std::vector<const Node *> _path;
+
+        explicit const_iterator(VersionPtr version) : _version(std::move(version))
+        {
+            descend_left(_version->_root.get());
+        }
+
+        void descend_left(const Node *node)
+        {
+            for (; node != nullptr; node = node->_left.get())
+                _path.push_back(node);
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+
+        reference operator*() const { return _path.back()->value; }
+        pointer operator->() const { return &_path.back()->value; }
+
+        const_iterator &operator++()
+        {
+            const Node *node = _path.back();
+            _path.pop_back();
+            descend_left(node->_right.get());
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return (_path.empty() ? nullptr : _path.back()) == (other._path.empty() ? nullptr : other._path.back());
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+    using iterator = const_iterator;
+
+    PersistentTreeSet();
+    explicit PersistentTreeSet(const Compare &comparator);
+    PersistentTreeSet(const std::vector<T> &items, const Compare &comparator = Compare());
+    PersistentTreeSet(const PersistentTreeSet &other);
+    PersistentTreeSet &operator=(const PersistentTreeSet &other);
+
+    // snapshot() - Returns an O(1) frozen copy of the current version
+    PersistentTreeSet snapshot() const;
+
+    // add() - Inserts value, replacing an equal one; returns false if one was replaced
+    bool add(const T &value);
+
+    bool remove(const T &value);
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const K &key);
+
+    bool contains(const T &value) const;
+    std::optional<T> get(const T &value) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::optional<T> get(const K &key) const;
+    // get_projected() - Returns project applied to the value matching key,
+    // while its version is still held, so a caller can copy out only a part
+    template <typename K, typename Project>
+    auto get_projected(const K &key, Project project) const
+        -> std::optional<std::decay_t<std::invoke_result_t<Project, const T &>>>;
+
+    std::optional<T> min() const;
+    std::optional<T> max() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    size_t size() const;
+    bool is_empty() const;
+    bool is_balanced() const;
+    std::vector<T> to_vector() const;
+    void clear();
+};
+
+#endif
@@ -5,48 +5,187 @@
 #include "TreeSet.cpp"
 #include <optional>
 #include <functional>
+#include <tuple>
 
-template <typename TKey, typename TValue>
-TreeMap<TKey, TValue>::TreeMap()
-    : _tree([](const std::pair<TKey, TValue> &a, const std::pair<TKey, TValue> &b)
-            {
-        if (a.first < b.first) return -1;
-        if (a.first > b.first) return 1;
-        return 0; }) {}
+template <typename TKey, typename TValue, typename Compare>
+TreeMap<TKey, TValue, Compare>::TreeMap() : TreeMap(std::pmr::get_default_resource()) {}
 
-// Constructor with a vector of items
-template <typename TKey, typename TValue>
-TreeMap<TKey, TValue>::TreeMap(const std::vector<std::pair<TKey, TValue>> &items)
-    : TreeMap()
+// Constructor drawing tree nodes from the given memory resource
+template <typename TKey, typename TValue, typename Compare>
+TreeMap<TKey, TValue, Compare>::TreeMap(std::pmr::memory_resource *resource)
+    : TreeMap(Compare(), resource) {}
+
+// Constructor with a key comparator
+template <typename TKey, typename TValue, typename Compare>
+TreeMap<TKey, TValue, Compare>::TreeMap(const Compare &comparator, std::pmr::memory_resource *resource)
+    : _tree(KeyCompare<TKey, TValue, Compare>(comparator), resource) {}
+
+// Constructor with a vector of items; sorted input is bulk loaded in linear time
+template <typename TKey, typename TValue, typename Compare>
+TreeMap<TKey, TValue, Compare>::TreeMap(const std::vector<std::pair<TKey, TValue>> &items)
+    : _tree(items) {}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename InputIt>
+TreeMap<TKey, TValue, Compare> TreeMap<TKey, TValue, Compare>::from_sorted_range(
+    InputIt first, InputIt last, const Compare &comparator, std::pmr::memory_resource *resource)
+{
+    TreeMap result(comparator, resource);
+    result._tree = Tree::from_sorted_range(
+        first, last, KeyCompare<TKey, TValue, Compare>(comparator), resource);
+    return result;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+void TreeMap<TKey, TValue, Compare>::insert(TKey key, TValue value)
+{
+    insert_or_assign(std::move(key), std::move(value));
+}
+
+// try_emplace() - The entry is constructed straight into a new node, and only
+// once the search has missed; args are left untouched when key is present
+template <typename TKey, typename TValue, typename Compare>
+template <typename... Args>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, bool> TreeMap<TKey, TValue, Compare>::try_emplace(
+    const TKey &key, Args &&...args)
+{
+    return _tree.try_emplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename... Args>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, bool> TreeMap<TKey, TValue, Compare>::try_emplace(
+    TKey &&key, Args &&...args)
+{
+    return _tree.try_emplace(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename M>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, bool> TreeMap<TKey, TValue, Compare>::insert_or_assign(
+    const TKey &key, M &&value)
+{
+    std::pair<const_iterator, bool> result = try_emplace(key, std::forward<M>(value));
+    if (!result.second)
+        const_cast<std::pair<TKey, TValue> &>(*result.first).second = std::forward<M>(value);
+    return result;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename M>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, bool> TreeMap<TKey, TValue, Compare>::insert_or_assign(
+    TKey &&key, M &&value)
+{
+    std::pair<const_iterator, bool> result = try_emplace(std::move(key), std::forward<M>(value));
+    if (!result.second)
+        const_cast<std::pair<TKey, TValue> &>(*result.first).second = std::forward<M>(value);
+    return result;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename... Args>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, bool> TreeMap<TKey, TValue, Compare>::emplace(
+    Args &&...args)
+{
+    return _tree.emplace(std::forward<Args>(args)...);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+bool TreeMap<TKey, TValue, Compare>::erase(const TKey &key)
+{
+    return _tree.remove(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::erase(const_iterator position)
 {
-    for (const auto &item : items)
+    return _tree.erase(position);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::erase(const_iterator first,
+                                                                                             const_iterator last)
+{
+    return _tree.erase(first, last);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+size_t TreeMap<TKey, TValue, Compare>::size() const
+{
+    return _tree.size();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::optional<TValue> TreeMap<TKey, TValue, Compare>::get(const TKey &key) const
+{
+    const TValue *value = find(key);
+
+    if (value)
     {
-        _tree.add(item);
+        return *value;
+    }
+    else
+    {
+        return std::nullopt;
     }
 }
 
-template <typename TKey, typename TValue>
-void TreeMap<TKey, TValue>::insert(TKey key, TValue value)
+template <typename TKey, typename TValue, typename Compare>
+bool TreeMap<TKey, TValue, Compare>::contains(const TKey &key) const
 {
-    _tree.add(std::make_pair(key, value));
+    return _tree.contains(key);
 }
 
-template <typename TKey, typename TValue>
-size_t TreeMap<TKey, TValue>::size() const
+// find() - Entries are stored mutably in their nodes, so handing out the value is safe;
+// only the key takes part in the ordering
+template <typename TKey, typename TValue, typename Compare>
+TValue *TreeMap<TKey, TValue, Compare>::find(const TKey &key)
 {
-    return _tree.size();
+    const std::pair<TKey, TValue> *entry = _tree.find(key);
+    return entry == nullptr ? nullptr : &const_cast<std::pair<TKey, TValue> *>(entry)->second;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+const TValue *TreeMap<TKey, TValue, Compare>::find(const TKey &key) const
+{
+    const std::pair<TKey, TValue> *entry = _tree.find(key);
+    return entry == nullptr ? nullptr : &entry->second;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<bool> TreeMap<TKey, TValue, Compare>::contains_batch(const std::vector<TKey> &keys) const
+{
+    std::vector<const std::pair<TKey, TValue> *> entries = _tree.find_batch(keys);
+    std::vector<bool> result(entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+        result[i] = entries[i] != nullptr;
+    return result;
 }
 
-template <typename TKey, typename TValue>
-std::optional<TValue> TreeMap<TKey, TValue>::get(TKey key) const
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::optional<TValue>> TreeMap<TKey, TValue, Compare>::get_batch(const std::vector<TKey> &keys) const
 {
-    auto search_pair = std::make_pair(key, TValue{});
+    std::vector<const std::pair<TKey, TValue> *> entries = _tree.find_batch(keys);
+    std::vector<std::optional<TValue>> result(entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i] != nullptr)
+            result[i] = entries[i]->second;
+    }
+    return result;
+}
 
-    auto result = _tree.get(search_pair);
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+std::optional<TValue> TreeMap<TKey, TValue, Compare>::get(const K &key) const
+{
+    const TValue *value = find(key);
 
-    if (result)
+    if (value)
     {
-        return result->second;
+        return *value;
     }
     else
     {
@@ -54,37 +193,156 @@ std::optional<TValue> TreeMap<TKey, TValue>::get(TKey key) const
     }
 }
 
-template <typename TKey, typename TValue>
-bool TreeMap<TKey, TValue>::contains(TKey key) const
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+bool TreeMap<TKey, TValue, Compare>::contains(const K &key) const
+{
+    return _tree.contains(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+TValue *TreeMap<TKey, TValue, Compare>::find(const K &key)
+{
+    const std::pair<TKey, TValue> *entry = _tree.find(key);
+    return entry == nullptr ? nullptr : &const_cast<std::pair<TKey, TValue> *>(entry)->second;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+template <typename K, typename C, typename>
+const TValue *TreeMap<TKey, TValue, Compare>::find(const K &key) const
+{
+    const std::pair<TKey, TValue> *entry = _tree.find(key);
+    return entry == nullptr ? nullptr : &entry->second;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::begin() const
+{
+    return _tree.begin();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::end() const
+{
+    return _tree.end();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_reverse_iterator TreeMap<TKey, TValue, Compare>::rbegin() const
+{
+    return _tree.rbegin();
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_reverse_iterator TreeMap<TKey, TValue, Compare>::rend() const
+{
+    return _tree.rend();
+}
+
+// lower_bound() - First entry whose key is not ordered before key
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::lower_bound(const TKey &key) const
+{
+    return _tree.lower_bound(key);
+}
+
+// upper_bound() - First entry whose key is ordered after key
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::upper_bound(const TKey &key) const
 {
-    auto search_pair = std::make_pair(key, TValue{});
-    auto result = _tree.get(search_pair);
-    return result.has_value();
+    return _tree.upper_bound(key);
 }
 
-template <typename TKey, typename TValue>
-std::vector<std::pair<TKey, TValue>> TreeMap<TKey, TValue>::to_vector() const
+template <typename TKey, typename TValue, typename Compare>
+std::pair<typename TreeMap<TKey, TValue, Compare>::const_iterator, typename TreeMap<TKey, TValue, Compare>::const_iterator>
+TreeMap<TKey, TValue, Compare>::equal_range(const TKey &key) const
+{
+    return _tree.equal_range(key);
+}
+
+template <typename TKey, typename TValue, typename Compare>
+IteratorRange<typename TreeMap<TKey, TValue, Compare>::const_iterator> TreeMap<TKey, TValue, Compare>::range(
+    const TKey &lo, const TKey &hi) const
+{
+    // Empty when the first candidate is already at or past hi, which also covers hi <= lo
+    const_iterator first = _tree.lower_bound(lo);
+    if (first == _tree.end() || !_tree.key_comp()(*first, hi))
+        return {first, first};
+    return {first, _tree.lower_bound(hi)};
+}
+
+template <typename TKey, typename TValue, typename Compare>
+IteratorRange<typename TreeMap<TKey, TValue, Compare>::const_reverse_iterator> TreeMap<TKey, TValue, Compare>::
+    reverse_range(const TKey &lo, const TKey &hi) const
+{
+    IteratorRange<const_iterator> forward = range(lo, hi);
+    return {const_reverse_iterator(forward.end()), const_reverse_iterator(forward.begin())};
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::floor(const TKey &key) const
+{
+    const_iterator after = _tree.upper_bound(key);
+    if (after == _tree.begin())
+        return _tree.end();
+    return --after;
+}
+
+template <typename TKey, typename TValue, typename Compare>
+typename TreeMap<TKey, TValue, Compare>::const_iterator TreeMap<TKey, TValue, Compare>::ceiling(const TKey &key) const
+{
+    return _tree.lower_bound(key);
+}
+
+// first_n_after() - Walks at most n successors from the first key above key
+template <typename TKey, typename TValue, typename Compare>
+IteratorRange<typename TreeMap<TKey, TValue, Compare>::const_iterator> TreeMap<TKey, TValue, Compare>::first_n_after(
+    const TKey &key, size_t n) const
+{
+    const_iterator first = _tree.upper_bound(key);
+    const_iterator last = first;
+    for (size_t i = 0; i < n && last != _tree.end(); i++)
+        ++last;
+    return {first, last};
+}
+
+// last_n_before() - Walks at most n predecessors from the last key below key
+template <typename TKey, typename TValue, typename Compare>
+IteratorRange<typename TreeMap<TKey, TValue, Compare>::const_reverse_iterator> TreeMap<TKey, TValue, Compare>::
+    last_n_before(const TKey &key, size_t n) const
+{
+    const_reverse_iterator first(_tree.lower_bound(key));
+    const_reverse_iterator last = first;
+    for (size_t i = 0; i < n && last != _tree.rend(); i++)
+        ++last;
+    return {first, last};
+}
+
+template <typename TKey, typename TValue, typename Compare>
+std::vector<std::pair<TKey, TValue>> TreeMap<TKey, TValue, Compare>::to_vector() const
 {
     std::vector<std::pair<TKey, TValue>> elements = _tree.to_vector();
     return elements;
 }
 
-template <typename TKey, typename TValue>
-bool TreeMap<TKey, TValue>::is_empty() const
+template <typename TKey, typename TValue, typename Compare>
+bool TreeMap<TKey, TValue, Compare>::is_empty() const
 {
     return _tree.size() == 0;
 }
 
-template <typename TKey, typename TValue>
-void TreeMap<TKey, TValue>::clear()
+// key_comp() - Returns a copy of the comparator ordering the keys
+template <typename TKey, typename TValue, typename Compare>
+Compare TreeMap<TKey, TValue, Compare>::key_comp() const
 {
-    _tree.clear();
+    return _tree.key_comp().key_compare();
 }
 
-template <typename TKey, typename TValue>
-TreeMap<TKey, TValue>::~TreeMap()
+template <typename TKey, typename TValue, typename Compare>
+void TreeMap<TKey, TValue, Compare>::clear()
 {
-    clear();
+    _tree.clear();
 }
 
 #endif
@@ -0,0 +1,153 @@
+#ifndef TREE_MAP_HPP
+#define TREE_MAP_HPP
+
+#include "TreeSet.hpp"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Orders map entries by key alone. It is transparent, so the underlying
+// TreeSet can be probed with a bare key instead of a (key, value) pair.
+template <typename TKey, typename TValue, typename Compare>
+class KeyCompare : private ComparatorStorage<Compare>
+{
+public:
+    using is_transparent = void;
+    using Entry = std::pair<TKey, TValue>;
+
+    KeyCompare(const Compare &compare = Compare()) : ComparatorStorage<Compare>(compare) {}
+
+    // key_compare() - The comparator applied to the keys
+    const Compare &key_compare() const { return this->comparator(); }
+
+    bool operator()(const Entry &left, const Entry &right) const { return this->comparator()(left.first, right.first); }
+    bool operator()(const Entry &left, const TKey &right) const { return this->comparator()(left.first, right); }
+    bool operator()(const TKey &left, const Entry &right) const { return this->comparator()(left, right.first); }
+
+    // Keys of other types (e.g. std::string_view against std::string) when Compare is transparent
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool operator()(const Entry &left, const K &right) const { return this->comparator()(left.first, right); }
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool operator()(const K &left, const Entry &right) const { return this->comparator()(left, right.first); }
+};
+
+// Lightweight view of [first, last) in a map; copying it copies two iterators, not entries.
+template <typename Iterator>
+class IteratorRange
+{
+private:
+    Iterator _first;
+    Iterator _last;
+
+public:
+    IteratorRange(Iterator first, Iterator last) : _first(first), _last(last) {}
+
+    Iterator begin() const { return _first; }
+    Iterator end() const { return _last; }
+    bool empty() const { return _first == _last; }
+    // size() - Counts the entries by walking them, O(k)
+    size_t size() const { return static_cast<size_t>(std::distance(_first, _last)); }
+};
+
+template <typename TKey, typename TValue, typename Compare = std::less<TKey>>
+class TreeMap
+{
+private:
+    using Tree = TreeSet<std::pair<TKey, TValue>, KeyCompare<TKey, TValue, Compare>>;
+
+    Tree _tree;
+
+public:
+    // Iterators walk the entries in key order without copying them
+    using const_iterator = typename Tree::const_iterator;
+    using iterator = const_iterator;
+    using const_reverse_iterator = typename Tree::const_reverse_iterator;
+    using reverse_iterator = const_reverse_iterator;
+
+    TreeMap();
+    explicit TreeMap(std::pmr::memory_resource *resource);
+    explicit TreeMap(const Compare &comparator,
+                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    TreeMap(const std::vector<std::pair<TKey, TValue>> &items);
+
+    // from_sorted_range() - Builds a map in linear time from entries with strictly ascending keys
+    template <typename InputIt>
+    static TreeMap from_sorted_range(InputIt first, InputIt last, const Compare &comparator = Compare(),
+                                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    // insert() - Sets the value for key, adding the entry if needed
+    void insert(TKey key, TValue value);
+
+    // try_emplace() - Adds key with a value built from args, unless key is present; like std::map
+    template <typename... Args>
+    std::pair<const_iterator, bool> try_emplace(const TKey &key, Args &&...args);
+    template <typename... Args>
+    std::pair<const_iterator, bool> try_emplace(TKey &&key, Args &&...args);
+    // insert_or_assign() - Adds key with value, or assigns value to the existing entry
+    template <typename M>
+    std::pair<const_iterator, bool> insert_or_assign(const TKey &key, M &&value);
+    template <typename M>
+    std::pair<const_iterator, bool> insert_or_assign(TKey &&key, M &&value);
+    // emplace() - Builds an entry from args and adds it unless its key is present
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(Args &&...args);
+
+    // erase() - Removes the entry for key, the entry at position, or every entry in [first, last)
+    bool erase(const TKey &key);
+    const_iterator erase(const_iterator position);
+    const_iterator erase(const_iterator first, const_iterator last);
+    std::optional<TValue> get(const TKey &key) const;
+    bool contains(const TKey &key) const;
+
+    // find() - Points at the stored value for key, or nullptr; nothing is copied
+    TValue *find(const TKey &key);
+    const TValue *find(const TKey &key) const;
+
+    // Batched lookups with interleaved searches; results line up with keys
+    std::vector<bool> contains_batch(const std::vector<TKey> &keys) const;
+    std::vector<std::optional<TValue>> get_batch(const std::vector<TKey> &keys) const;
+
+    // Heterogeneous lookups, available when Compare declares is_transparent
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::optional<TValue> get(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    TValue *find(const K &key);
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const TValue *find(const K &key) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    const_iterator lower_bound(const TKey &key) const;
+    const_iterator upper_bound(const TKey &key) const;
+    std::pair<const_iterator, const_iterator> equal_range(const TKey &key) const;
+
+    // Ordered scans; each costs O(log n) to find its start plus O(1) per entry visited.
+    // range() - Entries with keys in [lo, hi); reverse_range() - the same, largest key first
+    IteratorRange<const_iterator> range(const TKey &lo, const TKey &hi) const;
+    IteratorRange<const_reverse_iterator> reverse_range(const TKey &lo, const TKey &hi) const;
+    // floor() - Entry with the greatest key not above key; ceiling() - the least key not below it; end() if none
+    const_iterator floor(const TKey &key) const;
+    const_iterator ceiling(const TKey &key) const;
+    // first_n_after() - Up to n entries with keys above key, ascending (the next page)
+    IteratorRange<const_iterator> first_n_after(const TKey &key, size_t n) const;
+    // last_n_before() - Up to n entries with keys below key, descending (the previous page)
+    IteratorRange<const_reverse_iterator> last_n_before(const TKey &key, size_t n) const;
+
+    size_t size() const;
+    bool is_empty() const;
+    Compare key_comp() const;
+    std::vector<std::pair<TKey, TValue>> to_vector() const;
+    void clear();
+};
+
+#endif
@@ -5,38 +5,74 @@
 #include "BinaryTreeNode.hpp"
 #include <optional>
 #include <vector>
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "NodePool.cpp"
 
 // Constructor
-template <typename T>
-TreeSet<T>::TreeSet() : _root(nullptr), _size(0)
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet() : TreeSet(Compare()) {}
+
+// Constructor drawing nodes from the given memory resource
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(std::pmr::memory_resource *resource) : TreeSet(Compare(), resource) {}
+
+// Constructor with a comparator
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(const Compare &comparator, std::pmr::memory_resource *resource)
+    : ComparatorStorage<Compare>(comparator), _root(nullptr), _size(0), _pool(resource) {}
+
+// Constructor with a vector of items
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(const std::vector<T> &items) : TreeSet()
 {
-    _comparator = [](T left, T right)
-    {
-        if (left < right)
-            return -1;
-        else if (left > right)
-            return 1;
-        return 0;
-    };
+    load(items);
 }
 
-// Constructor with a comparator function
-template <typename T>
-TreeSet<T>::TreeSet(std::function<int(T, T)> comparator) : _root(nullptr), _size(0), _comparator(comparator) {}
+// Constructor with both a vector of items and a comparator
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(const std::vector<T> &items, const Compare &comparator,
+                             std::pmr::memory_resource *resource)
+    : TreeSet(comparator, resource)
+{
+    load(items);
+}
 
-// Constructor with a vector of items
-template <typename T>
-TreeSet<T>::TreeSet(const std::vector<T> &items) : _root(nullptr), _size(0)
+template <typename T, typename Compare, typename Stats>
+template <typename InputIt>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::from_sorted_range(InputIt first, InputIt last, const Compare &comparator,
+                                                           std::pmr::memory_resource *resource)
 {
-    _comparator = [](T left, T right)
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    TreeSet result(comparator, resource);
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>)
     {
-        if (left < right)
-            return -1;
-        else if (left > right)
-            return 1;
-        return 0;
-    };
+        result.build_sorted(first, static_cast<size_t>(std::distance(first, last)));
+    }
+    else
+    {
+        // Single-pass input has to be counted before the shape can be chosen
+        std::vector<T> buffered(first, last);
+        result.build_sorted(buffered.begin(), buffered.size());
+    }
+    return result;
+}
+
+// load() - Builds from items, in linear time when they are already strictly ascending
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::load(const std::vector<T> &items)
+{
+    auto out_of_order = std::adjacent_find(items.begin(), items.end(), [this](const T &left, const T &right)
+                                           { return !comparator()(left, right); });
+    if (out_of_order == items.end())
+    {
+        build_sorted(items.begin(), items.size());
+        return;
+    }
 
     for (const T &item : items)
     {
@@ -44,216 +80,962 @@ TreeSet<T>::TreeSet(const std::vector<T> &items) : _root(nullptr), _size(0)
     }
 }
 
-// Constructor with both a vector of items and a comparator function
-template <typename T>
-TreeSet<T>::TreeSet(const std::vector<T> &items, std::function<int(T, T)> comparator)
-    : _root(nullptr), _size(0), _comparator(comparator)
+// build_sorted() - Fills an empty tree with count ascending values read from first
+template <typename T, typename Compare, typename Stats>
+template <typename InputIt>
+void TreeSet<T, Compare, Stats>::build_sorted(InputIt first, size_t count)
 {
+    auto next_node = [&]()
+    {
+        BinaryTreeNode<T, Stats> *node = _pool.create(*first);
+        ++first;
+        return node;
+    };
+    build_sorted(count, next_node);
+}
 
-    for (const T &item : items)
+// build_sorted() - Links count nodes, produced in ascending order by next_node, into an empty tree
+template <typename T, typename Compare, typename Stats>
+template <typename NextNode>
+void TreeSet<T, Compare, Stats>::build_sorted(size_t count, NextNode &next_node)
+{
+    // Halving the range fills every level but the deepest one; coloring that level red
+    // keeps the black height equal on every path.
+    size_t red_depth = 0;
+    while ((size_t(2) << red_depth) <= count)
+        red_depth++;
+
+    _root = link_sorted(count, 0, red_depth, nullptr, next_node);
+    if (_root != nullptr)
+        _root->_color = Black;
+    _size = count;
+}
+
+// link_sorted() - Builds a balanced subtree of count nodes in order, returning its root
+template <typename T, typename Compare, typename Stats>
+template <typename NextNode>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::link_sorted(size_t count, size_t depth, size_t red_depth,
+                                                    BinaryTreeNode<T, Stats> *parent, NextNode &next_node)
+{
+    if (count == 0)
+        return nullptr;
+
+    size_t left_count = (count - 1) / 2;
+    BinaryTreeNode<T, Stats> *left = link_sorted(left_count, depth + 1, red_depth, nullptr, next_node);
+
+    BinaryTreeNode<T, Stats> *node = next_node();
+    node->_parent = parent;
+    node->_color = depth == red_depth ? Red : Black;
+    node->_left = left;
+    if (left != nullptr)
+        left->_parent = node;
+    node->_right = link_sorted(count - 1 - left_count, depth + 1, red_depth, node, next_node);
+    update_size(node);
+    return node;
+}
+
+// Copy constructor - Clones the node structure into a pool on the same memory resource
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(const TreeSet &other)
+    : ComparatorStorage<Compare>(other.comparator()), _root(nullptr), _size(other._size),
+      _pool(other._pool.resource())
+{
+    _root = clone_subtree(other._root, nullptr);
+}
+
+// Move constructor - Takes over the nodes and the pool that owns them
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::TreeSet(TreeSet &&other) noexcept(std::is_nothrow_copy_constructible_v<Compare>)
+    : ComparatorStorage<Compare>(other.comparator()), _root(std::exchange(other._root, nullptr)),
+      _size(std::exchange(other._size, 0)), _pool(std::move(other._pool)) {}
+
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> &TreeSet<T, Compare, Stats>::operator=(const TreeSet &other)
+{
+    if (this != &other)
     {
-        add(item);
+        TreeSet copy(other);
+        *this = std::move(copy);
     }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> &TreeSet<T, Compare, Stats>::operator=(TreeSet &&other) noexcept(
+    std::is_nothrow_copy_assignable_v<Compare>)
+{
+    if (this != &other)
+    {
+        // The comparator goes first so a throwing copy leaves both sets intact
+        ComparatorStorage<Compare>::operator=(other);
+        clear();
+        _root = std::exchange(other._root, nullptr);
+        _size = std::exchange(other._size, 0);
+        _pool = std::move(other._pool);
+    }
+    return *this;
+}
+
+// clone_subtree() - Copies a subtree node by node, keeping its shape and colors.
+// Walks source and copy in lockstep through parent links, so no stack is used.
+template <typename T, typename Compare, typename Stats>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::clone_subtree(const BinaryTreeNode<T, Stats> *node, BinaryTreeNode<T, Stats> *parent)
+{
+    if (node == nullptr)
+        return nullptr;
+
+    auto copy_node = [&](const BinaryTreeNode<T, Stats> *source, BinaryTreeNode<T, Stats> *copy_parent)
+    {
+        BinaryTreeNode<T, Stats> *copy = _pool.create(source->value);
+        copy->_color = source->_color;
+        copy->_parent = copy_parent;
+        return copy;
+    };
+
+    BinaryTreeNode<T, Stats> *root = copy_node(node, parent);
+    const BinaryTreeNode<T, Stats> *source = node;
+    BinaryTreeNode<T, Stats> *copy = root;
+    while (true)
+    {
+        if (source->_left != nullptr && copy->_left == nullptr)
+        {
+            copy->_left = copy_node(source->_left, copy);
+            source = source->_left;
+            copy = copy->_left;
+        }
+        else if (source->_right != nullptr && copy->_right == nullptr)
+        {
+            copy->_right = copy_node(source->_right, copy);
+            source = source->_right;
+            copy = copy->_right;
+        }
+        else
+        {
+            // Both children done: finish this node and climb back up
+            update_size(copy);
+            if (source == node)
+                break;
+            source = source->_parent;
+            copy = copy->_parent;
+        }
+    }
+    return root;
 }
 
 // size() - Returns the number of elements in the tree
-template <typename T>
-size_t TreeSet<T>::size() const
+template <typename T, typename Compare, typename Stats>
+size_t TreeSet<T, Compare, Stats>::size() const
 {
     return _size;
 }
 
 // is_empty() - Checks if the set is empty
-template <typename T>
-bool TreeSet<T>::is_empty() const
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::is_empty() const
 {
     return _size == 0;
 }
 
+// is_balanced() - Checks the red-black invariants: black root, no red-red edge, equal black height
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::is_balanced() const
+{
+    if (_root != nullptr && _root->_color != Black)
+        return false;
+    return black_height(_root) != -1;
+}
+
+// black_height() - Returns the black height of a subtree, or -1 if it breaks an invariant
+template <typename T, typename Compare, typename Stats>
+int TreeSet<T, Compare, Stats>::black_height(const BinaryTreeNode<T, Stats> *node) const
+{
+    if (node == nullptr)
+        return 1;
+    if (node->_color == Red &&
+        ((node->_left && node->_left->_color == Red) || (node->_right && node->_right->_color == Red)))
+        return -1;
+
+    int left = black_height(node->_left);
+    int right = black_height(node->_right);
+    if (left == -1 || right == -1 || left != right)
+        return -1;
+    return left + (node->_color == Black ? 1 : 0);
+}
+
+// key_comp() - Returns a copy of the comparator ordering the set
+template <typename T, typename Compare, typename Stats>
+Compare TreeSet<T, Compare, Stats>::key_comp() const
+{
+    return comparator();
+}
+
 // add() - Adds a value to the tree, replacing the existing value if present
-template <typename T>
-void TreeSet<T>::add(T value)
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::add(T value)
 {
-    BinaryTreeNode<T> *newNode = new BinaryTreeNode<T>(value);
-    newNode->_left = newNode->_right = nullptr;
-    newNode->_color = Color::Red;
+    std::pair<BinaryTreeNode<T, Stats> *, bool> result = insert_unique(value, std::move(value));
+    if (!result.second)
+        result.first->value = std::move(value);
+}
 
-    if (_root == nullptr)
+template <typename T, typename Compare, typename Stats>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, bool> TreeSet<T, Compare, Stats>::insert(const T &value)
+{
+    std::pair<BinaryTreeNode<T, Stats> *, bool> result = insert_unique(value, value);
+    return {const_iterator(result.first, this), result.second};
+}
+
+template <typename T, typename Compare, typename Stats>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, bool> TreeSet<T, Compare, Stats>::insert(T &&value)
+{
+    std::pair<BinaryTreeNode<T, Stats> *, bool> result = insert_unique(value, std::move(value));
+    return {const_iterator(result.first, this), result.second};
+}
+
+// emplace() - The key is only known once the value exists, so it is built on
+// the stack first and moved into a node if the search misses
+template <typename T, typename Compare, typename Stats>
+template <typename... Args>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, bool> TreeSet<T, Compare, Stats>::emplace(Args &&...args)
+{
+    return insert(T(std::forward<Args>(args)...));
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename... Args>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, bool> TreeSet<T, Compare, Stats>::try_emplace(
+    const K &key, Args &&...args)
+{
+    std::pair<BinaryTreeNode<T, Stats> *, bool> result = insert_unique(key, std::forward<Args>(args)...);
+    return {const_iterator(result.first, this), result.second};
+}
+
+// insert_unique() - Looks for key and returns the matching node, or links in
+// a node built from args when there is none; args are untouched on a match
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename... Args>
+std::pair<BinaryTreeNode<T, Stats> *, bool> TreeSet<T, Compare, Stats>::insert_unique(const K &key, Args &&...args)
+{
+    BinaryTreeNode<T, Stats> *current = _root;
+    BinaryTreeNode<T, Stats> *parent = nullptr;
+    bool go_left = false;
+
+    while (current != nullptr)
+    {
+        parent = current;
+        go_left = comparator()(key, current->value);
+        if (go_left)
+        {
+            current = current->_left;
+        }
+        else if (comparator()(current->value, key))
+        {
+            current = current->_right;
+        }
+        else
+        {
+            return {current, false};
+        }
+    }
+
+    BinaryTreeNode<T, Stats> *newNode = _pool.create(std::in_place, std::forward<Args>(args)...);
+    newNode->_parent = parent;
+    if (parent == nullptr)
     {
         _root = newNode;
-        _root->_color = Color::Black;
+    }
+    else if (go_left)
+    {
+        parent->_left = newNode;
     }
     else
     {
-        BinaryTreeNode<T> *current = _root;
-        BinaryTreeNode<T> *parent = nullptr;
+        parent->_right = newNode;
+    }
+
+    update_sizes_to_root(parent);
+    fix_violation(newNode);
+    _size++;
+    return {newNode, true};
+}
+
+// remove() - Deletes the element equivalent to value, if present
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::remove(const T &value)
+{
+    BinaryTreeNode<T, Stats> *node = find_node(value);
+    if (node == nullptr)
+        return false;
+    erase_node(node);
+    return true;
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+bool TreeSet<T, Compare, Stats>::remove(const K &key)
+{
+    BinaryTreeNode<T, Stats> *node = find_node(key);
+    if (node == nullptr)
+        return false;
+    erase_node(node);
+    return true;
+}
+
+// erase() - Deletes the element at position and returns an iterator to the next one
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::erase(const_iterator position)
+{
+    // erase_node() relinks nodes rather than moving values, so the successor stays valid
+    BinaryTreeNode<T, Stats> *next = successor(position._node);
+    erase_node(position._node);
+    return const_iterator(next, this);
+}
+
+// erase() - Deletes every element in [first, last)
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::erase(const_iterator first, const_iterator last)
+{
+    if (first == begin() && last == end())
+    {
+        clear();
+        return end();
+    }
+    while (first != last)
+        first = erase(first);
+    return last;
+}
+
+// find_node() - Locates the node equivalent to key, or nullptr; one comparison per level
+template <typename T, typename Compare, typename Stats>
+template <typename K>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::find_node(const K &key) const
+{
+    BinaryTreeNode<T, Stats> *candidate = lower_bound_node(key);
+    if (candidate != nullptr && !comparator()(key, candidate->value))
+        return candidate;
+    return nullptr;
+}
+
+// search_batch() - Runs the lower-bound descent of find_node() for many keys
+// at once. A fixed group of searches advances one level per round, and each
+// step prefetches the child it moves to, so by the time a search is resumed
+// its node is usually in cache. A finished search hands its slot to the next
+// key, keeping the group full. visit(i, node) receives each result.
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename Visit>
+void TreeSet<T, Compare, Stats>::search_batch(const std::vector<K> &keys, Visit visit) const
+{
+    constexpr size_t GROUP = 16;
 
-        while (current != nullptr)
+    struct Search
+    {
+        size_t index;
+        BinaryTreeNode<T, Stats> *current;
+        BinaryTreeNode<T, Stats> *candidate;
+    };
+
+    Search searches[GROUP];
+    size_t active = 0;
+    size_t next = 0;
+    while (active < GROUP && next < keys.size())
+        searches[active++] = {next++, _root, nullptr};
+
+    while (active > 0)
+    {
+        for (size_t i = 0; i < active;)
         {
-            parent = current;
-            int comparison = _comparator(value, current->value);
-            if (comparison == 0)
+            Search &search = searches[i];
+            if (search.current == nullptr)
             {
-                current->value = value;
-                delete newNode;
-                return;
+                BinaryTreeNode<T, Stats> *candidate = search.candidate;
+                const K &key = keys[search.index];
+                visit(search.index, candidate != nullptr && !comparator()(key, candidate->value) ? candidate : nullptr);
+
+                if (next < keys.size())
+                    search = {next++, _root, nullptr};
+                else
+                    search = searches[--active]; // Retire the slot; re-examine the one moved in
+                continue;
             }
-            else if (comparison < 0)
+
+            if (comparator()(search.current->value, keys[search.index]))
             {
-                current = current->_left;
+                search.current = search.current->_right;
             }
             else
             {
-                current = current->_right;
+                search.candidate = search.current;
+                search.current = search.current->_left;
             }
+            if (search.current != nullptr)
+                __builtin_prefetch(search.current);
+            i++;
         }
+    }
+}
+
+template <typename T, typename Compare, typename Stats>
+std::vector<bool> TreeSet<T, Compare, Stats>::contains_batch(const std::vector<T> &values) const
+{
+    std::vector<bool> result(values.size());
+    search_batch(values, [&](size_t i, BinaryTreeNode<T, Stats> *node)
+                 { result[i] = node != nullptr; });
+    return result;
+}
 
-        newNode->_parent = parent;
-        if (_comparator(value, parent->value) < 0)
+template <typename T, typename Compare, typename Stats>
+std::vector<std::optional<T>> TreeSet<T, Compare, Stats>::get_batch(const std::vector<T> &values) const
+{
+    std::vector<std::optional<T>> result(values.size());
+    search_batch(values, [&](size_t i, BinaryTreeNode<T, Stats> *node)
+                 {
+        if (node != nullptr)
+            result[i] = node->value; });
+    return result;
+}
+
+template <typename T, typename Compare, typename Stats>
+std::vector<const T *> TreeSet<T, Compare, Stats>::find_batch(const std::vector<T> &values) const
+{
+    std::vector<const T *> result(values.size());
+    search_batch(values, [&](size_t i, BinaryTreeNode<T, Stats> *node)
+                 { result[i] = node == nullptr ? nullptr : &node->value; });
+    return result;
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+std::vector<const T *> TreeSet<T, Compare, Stats>::find_batch(const std::vector<K> &keys) const
+{
+    std::vector<const T *> result(keys.size());
+    search_batch(keys, [&](size_t i, BinaryTreeNode<T, Stats> *node)
+                 { result[i] = node == nullptr ? nullptr : &node->value; });
+    return result;
+}
+
+// lower_bound_node() - Returns the first node whose value is not ordered before key
+template <typename T, typename Compare, typename Stats>
+template <typename K>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::lower_bound_node(const K &key) const
+{
+    BinaryTreeNode<T, Stats> *current = _root;
+    BinaryTreeNode<T, Stats> *candidate = nullptr;
+    while (current != nullptr)
+    {
+        if (comparator()(current->value, key))
         {
-            parent->_left = newNode;
+            current = current->_right;
         }
         else
         {
-            parent->_right = newNode;
+            candidate = current;
+            current = current->_left;
         }
-
-        fix_violation(newNode);
     }
-
-    _size++;
+    return candidate;
 }
 
-// contains() - Checks if a value exists in the set
-template <typename T>
-bool TreeSet<T>::contains(T value) const
+// upper_bound_node() - Returns the first node whose value is ordered after key
+template <typename T, typename Compare, typename Stats>
+template <typename K>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::upper_bound_node(const K &key) const
 {
-    BinaryTreeNode<T> *current = _root;
+    BinaryTreeNode<T, Stats> *current = _root;
+    BinaryTreeNode<T, Stats> *candidate = nullptr;
     while (current != nullptr)
     {
-        int comparison = _comparator(value, current->value);
-        if (comparison == 0)
-            return true;
-        else if (comparison < 0)
+        if (comparator()(key, current->value))
+        {
+            candidate = current;
             current = current->_left;
+        }
         else
+        {
             current = current->_right;
+        }
     }
-    return false;
+    return candidate;
+}
+
+// contains() - Checks if a value exists in the set
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::contains(const T &value) const
+{
+    return find_node(value) != nullptr;
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+bool TreeSet<T, Compare, Stats>::contains(const K &key) const
+{
+    return find_node(key) != nullptr;
+}
+
+// find() - Returns a pointer to the stored element equivalent to value, or nullptr
+template <typename T, typename Compare, typename Stats>
+const T *TreeSet<T, Compare, Stats>::find(const T &value) const
+{
+    BinaryTreeNode<T, Stats> *node = find_node(value);
+    return node == nullptr ? nullptr : &node->value;
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+const T *TreeSet<T, Compare, Stats>::find(const K &key) const
+{
+    BinaryTreeNode<T, Stats> *node = find_node(key);
+    return node == nullptr ? nullptr : &node->value;
 }
 
 // min() - Finds the smallest value in the set
-template <typename T>
-std::optional<T> TreeSet<T>::min() const
+template <typename T, typename Compare, typename Stats>
+std::optional<T> TreeSet<T, Compare, Stats>::min() const
 {
     if (_root == nullptr)
         return std::nullopt;
-    BinaryTreeNode<T> *current = _root;
+    BinaryTreeNode<T, Stats> *current = _root;
     while (current->_left != nullptr)
         current = current->_left;
     return current->value;
 }
 
 // max() - Finds the largest value in the set
-template <typename T>
-std::optional<T> TreeSet<T>::max() const
+template <typename T, typename Compare, typename Stats>
+std::optional<T> TreeSet<T, Compare, Stats>::max() const
 {
     if (_root == nullptr)
         return std::nullopt;
-    BinaryTreeNode<T> *current = _root;
+    BinaryTreeNode<T, Stats> *current = _root;
     while (current->_right != nullptr)
         current = current->_right;
     return current->value;
 }
 
-template <typename T>
-std::vector<T> TreeSet<T>::to_vector() const
+template <typename T, typename Compare, typename Stats>
+std::vector<T> TreeSet<T, Compare, Stats>::to_vector() const
 {
     std::vector<T> result;
+    result.reserve(_size);
 
-    // In-order traversal using a lambda to add elements to result
-    std::function<void(BinaryTreeNode<T> *)> in_order = [&](BinaryTreeNode<T> *node)
-    {
-        if (node == nullptr)
-            return;
-        in_order(node->_left);
+    // In-order walk along parent links; no recursion and no extra stack
+    for (BinaryTreeNode<T, Stats> *node = leftmost(_root); node != nullptr; node = successor(node))
         result.push_back(node->value);
-        in_order(node->_right);
-    };
-
-    in_order(_root);
     return result;
 }
 
-// get() - Finds and returns a value in the tree if present
-template <typename T>
-std::optional<T> TreeSet<T>::get(T value) const
+// select() - Descends by subtree sizes to the k-th smallest element
+template <typename T, typename Compare, typename Stats>
+template <typename S, typename>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::select(size_t k) const
 {
-    BinaryTreeNode<T> *current = _root;
+    BinaryTreeNode<T, Stats> *current = _root;
     while (current != nullptr)
     {
-        int comparison = _comparator(value, current->value);
-        if (comparison == 0)
-            return current->value;
-        else if (comparison < 0)
+        size_t left_size = subtree_size(current->_left);
+        if (k < left_size)
+        {
             current = current->_left;
+        }
+        else if (k == left_size)
+        {
+            return const_iterator(current, this);
+        }
         else
+        {
+            k -= left_size + 1;
+            current = current->_right;
+        }
+    }
+    return end();
+}
+
+// rank() - Counts the elements ordered before value along one root-to-leaf path
+template <typename T, typename Compare, typename Stats>
+template <typename S, typename>
+size_t TreeSet<T, Compare, Stats>::rank(const T &value) const
+{
+    size_t count = 0;
+    BinaryTreeNode<T, Stats> *current = _root;
+    while (current != nullptr)
+    {
+        if (comparator()(current->value, value))
+        {
+            count += subtree_size(current->_left) + 1;
             current = current->_right;
+        }
+        else
+        {
+            current = current->_left;
+        }
     }
-    return std::nullopt;
+    return count;
+}
+
+// count_range() - Number of elements in [lo, hi)
+template <typename T, typename Compare, typename Stats>
+template <typename S, typename>
+size_t TreeSet<T, Compare, Stats>::count_range(const T &lo, const T &hi) const
+{
+    if (!comparator()(lo, hi))
+        return 0;
+    return rank(hi) - rank(lo);
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::begin() const
+{
+    return const_iterator(leftmost(_root), this);
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::end() const
+{
+    return const_iterator(nullptr, this);
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_reverse_iterator TreeSet<T, Compare, Stats>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_reverse_iterator TreeSet<T, Compare, Stats>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::lower_bound(const T &value) const
+{
+    return const_iterator(lower_bound_node(value), this);
+}
+
+template <typename T, typename Compare, typename Stats>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::upper_bound(const T &value) const
+{
+    return const_iterator(upper_bound_node(value), this);
+}
+
+template <typename T, typename Compare, typename Stats>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, typename TreeSet<T, Compare, Stats>::const_iterator>
+TreeSet<T, Compare, Stats>::equal_range(const T &value) const
+{
+    return {lower_bound(value), upper_bound(value)};
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::lower_bound(const K &key) const
+{
+    return const_iterator(lower_bound_node(key), this);
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+typename TreeSet<T, Compare, Stats>::const_iterator TreeSet<T, Compare, Stats>::upper_bound(const K &key) const
+{
+    return const_iterator(upper_bound_node(key), this);
+}
+
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+std::pair<typename TreeSet<T, Compare, Stats>::const_iterator, typename TreeSet<T, Compare, Stats>::const_iterator>
+TreeSet<T, Compare, Stats>::equal_range(const K &key) const
+{
+    return {lower_bound(key), upper_bound(key)};
+}
+
+// get() - Finds and returns a value in the tree if present
+template <typename T, typename Compare, typename Stats>
+std::optional<T> TreeSet<T, Compare, Stats>::get(const T &value) const
+{
+    BinaryTreeNode<T, Stats> *node = find_node(value);
+    if (node == nullptr)
+        return std::nullopt;
+    return node->value;
 }
 
-template <typename T>
-TreeSet<T> TreeSet<T>::operator+(const TreeSet &other)
+template <typename T, typename Compare, typename Stats>
+template <typename K, typename C, typename>
+std::optional<T> TreeSet<T, Compare, Stats>::get(const K &key) const
 {
-    TreeSet<T> result;
+    BinaryTreeNode<T, Stats> *node = find_node(key);
+    if (node == nullptr)
+        return std::nullopt;
+    return node->value;
+}
 
-    // Add all elements from the current set to result
-    for (const T &value : this->to_vector())
+// leftmost() - Returns the smallest node of a subtree
+template <typename T, typename Compare, typename Stats>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::leftmost(BinaryTreeNode<T, Stats> *node)
+{
+    if (node == nullptr)
+        return nullptr;
+    while (node->_left != nullptr)
+        node = node->_left;
+    return node;
+}
+
+// rightmost() - Returns the largest node of a subtree
+template <typename T, typename Compare, typename Stats>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::rightmost(BinaryTreeNode<T, Stats> *node)
+{
+    if (node == nullptr)
+        return nullptr;
+    while (node->_right != nullptr)
+        node = node->_right;
+    return node;
+}
+
+// successor() - Returns the next node in order by following child and parent links
+template <typename T, typename Compare, typename Stats>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::successor(BinaryTreeNode<T, Stats> *node)
+{
+    if (node->_right != nullptr)
+        return leftmost(node->_right);
+    while (node->_parent != nullptr && node == node->_parent->_right)
+        node = node->_parent;
+    return node->_parent;
+}
+
+// predecessor() - Returns the previous node in order, mirroring successor()
+template <typename T, typename Compare, typename Stats>
+BinaryTreeNode<T, Stats> *TreeSet<T, Compare, Stats>::predecessor(BinaryTreeNode<T, Stats> *node)
+{
+    if (node->_left != nullptr)
+        return rightmost(node->_left);
+    while (node->_parent != nullptr && node == node->_parent->_left)
+        node = node->_parent;
+    return node->_parent;
+}
+
+// merge_into() - Replaces this set with `left <operation> right`, computed by one in-order
+// merge of both sets. When this set is one of the operands its nodes are reused for the
+// result, and only elements coming from the other operand are copied.
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::merge_into(const TreeSet &left, const TreeSet &right, SetOperation operation)
+{
+    if (&left == &right)
     {
-        result.add(value);
+        bool keep = operation == SetOperation::Union || operation == SetOperation::Intersection;
+        if (this != &left)
+            *this = keep ? TreeSet(left) : TreeSet(comparator(), _pool.resource());
+        else if (!keep)
+            clear();
+        return;
     }
 
-    // Add all elements from the other set to result
-    for (const T &value : other.to_vector())
+    struct Pick
+    {
+        BinaryTreeNode<T, Stats> *own;
+        const T *copy;
+    };
+    std::vector<Pick> picked;
+    std::vector<BinaryTreeNode<T, Stats> *> spare;
+    bool left_is_mine = &left == this;
+    bool right_is_mine = &right == this;
+
+    // Keeps or drops one element; nodes of this set are only relinked once the walk is done
+    auto take = [&](BinaryTreeNode<T, Stats> *node, bool mine, bool keep)
     {
-        result.add(value);
+        if (keep)
+            picked.push_back(mine ? Pick{node, nullptr} : Pick{nullptr, &node->value});
+        else if (mine)
+            spare.push_back(node);
+    };
+
+    bool keep_left_only = operation != SetOperation::Intersection;
+    bool keep_right_only = operation == SetOperation::Union || operation == SetOperation::SymmetricDifference;
+
+    BinaryTreeNode<T, Stats> *l = leftmost(left._root);
+    BinaryTreeNode<T, Stats> *r = leftmost(right._root);
+    while (l != nullptr || r != nullptr)
+    {
+        if (r == nullptr || (l != nullptr && comparator()(l->value, r->value)))
+        {
+            BinaryTreeNode<T, Stats> *next = successor(l);
+            take(l, left_is_mine, keep_left_only);
+            l = next;
+        }
+        else if (l == nullptr || comparator()(r->value, l->value))
+        {
+            BinaryTreeNode<T, Stats> *next = successor(r);
+            take(r, right_is_mine, keep_right_only);
+            r = next;
+        }
+        else
+        {
+            BinaryTreeNode<T, Stats> *next_l = successor(l);
+            BinaryTreeNode<T, Stats> *next_r = successor(r);
+            take(l, left_is_mine, operation == SetOperation::Intersection);
+            take(r, right_is_mine, operation == SetOperation::Union);
+            l = next_l;
+            r = next_r;
+        }
     }
 
+    // Copied elements go into spare nodes first, so only the shortfall is allocated
+    for (Pick &pick : picked)
+    {
+        if (pick.own != nullptr)
+            continue;
+        if (!spare.empty())
+        {
+            pick.own = spare.back();
+            spare.pop_back();
+            pick.own->value = *pick.copy;
+        }
+        else
+        {
+            pick.own = _pool.create(*pick.copy);
+        }
+    }
+    for (BinaryTreeNode<T, Stats> *node : spare)
+        _pool.destroy(node);
+
+    size_t index = 0;
+    auto next_node = [&]()
+    { return picked[index++].own; };
+    _root = nullptr;
+    build_sorted(picked.size(), next_node);
+}
+
+// operator+ - Returns a new set with the elements of either set
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator+(const TreeSet &other) const &
+{
+    TreeSet result(comparator(), _pool.resource());
+    result.merge_into(*this, other, SetOperation::Union);
     return result;
 }
 
+// operator+ - Union built out of this temporary's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator+(const TreeSet &other) &&
+{
+    merge_into(*this, other, SetOperation::Union);
+    return std::move(*this);
+}
+
+// operator+ - Union built out of the temporary operand's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator+(TreeSet &&other) const &
+{
+    other.merge_into(*this, other, SetOperation::Union);
+    return std::move(other);
+}
+
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator+(TreeSet &&other) &&
+{
+    return std::move(*this) + static_cast<const TreeSet &>(other);
+}
+
 // operator+= - Adds all elements from other set to this set (in-place union)
-template <typename T>
-TreeSet<T> &TreeSet<T>::operator+=(const TreeSet &other)
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> &TreeSet<T, Compare, Stats>::operator+=(const TreeSet &other)
 {
-    for (const T &value : other.to_vector())
-    {
-        this->add(value);
-    }
+    merge_into(*this, other, SetOperation::Union);
     return *this;
 }
 
 // operator& - Returns a new set containing the intersection of this set and other
-template <typename T>
-TreeSet<T> TreeSet<T>::operator&(const TreeSet &other)
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator&(const TreeSet &other) const &
 {
-    TreeSet<T> result;
+    TreeSet result(comparator(), _pool.resource());
+    result.merge_into(*this, other, SetOperation::Intersection);
+    return result;
+}
 
-    for (const T &value : this->to_vector())
-    {
-        if (other.contains(value))
-        {
-            result.add(value);
-        }
-    }
+// operator& - Intersection built out of this temporary's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator&(const TreeSet &other) &&
+{
+    merge_into(*this, other, SetOperation::Intersection);
+    return std::move(*this);
+}
+
+// operator& - Intersection built out of the temporary operand's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator&(TreeSet &&other) const &
+{
+    other.merge_into(*this, other, SetOperation::Intersection);
+    return std::move(other);
+}
 
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator&(TreeSet &&other) &&
+{
+    return std::move(*this) & static_cast<const TreeSet &>(other);
+}
+
+// operator- - Returns a new set with the elements of this set that are not in other
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator-(const TreeSet &other) const &
+{
+    TreeSet result(comparator(), _pool.resource());
+    result.merge_into(*this, other, SetOperation::Difference);
     return result;
 }
 
+// operator- - Difference built out of this temporary's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator-(const TreeSet &other) &&
+{
+    merge_into(*this, other, SetOperation::Difference);
+    return std::move(*this);
+}
+
+// operator- - Difference built out of the temporary operand's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator-(TreeSet &&other) const &
+{
+    other.merge_into(*this, other, SetOperation::Difference);
+    return std::move(other);
+}
+
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator-(TreeSet &&other) &&
+{
+    return std::move(*this) - static_cast<const TreeSet &>(other);
+}
+
+// operator^ - Returns a new set with the elements in exactly one of the sets
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator^(const TreeSet &other) const &
+{
+    TreeSet result(comparator(), _pool.resource());
+    result.merge_into(*this, other, SetOperation::SymmetricDifference);
+    return result;
+}
+
+// operator^ - Symmetric difference built out of this temporary's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator^(const TreeSet &other) &&
+{
+    merge_into(*this, other, SetOperation::SymmetricDifference);
+    return std::move(*this);
+}
+
+// operator^ - Symmetric difference built out of the temporary operand's nodes
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator^(TreeSet &&other) const &
+{
+    other.merge_into(*this, other, SetOperation::SymmetricDifference);
+    return std::move(other);
+}
+
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats> TreeSet<T, Compare, Stats>::operator^(TreeSet &&other) &&
+{
+    return std::move(*this) ^ static_cast<const TreeSet &>(other);
+}
+
 // operator== - Checks if two sets contain the same elements
-template <typename T>
-bool TreeSet<T>::operator==(const TreeSet &other) const
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::operator==(const TreeSet &other) const
 {
     // If sizes are different, sets are not equal
     if (this->size() != other.size())
@@ -261,54 +1043,104 @@ bool TreeSet<T>::operator==(const TreeSet &other) const
         return false;
     }
 
-    // Check if all elements in this set are contained in the other set
-    for (const T &value : this->to_vector())
+    // Walk both sets in order; every pair of elements must be equivalent
+    BinaryTreeNode<T, Stats> *l = leftmost(_root);
+    BinaryTreeNode<T, Stats> *r = leftmost(other._root);
+    while (l != nullptr)
     {
-        if (!other.contains(value))
+        if (comparator()(l->value, r->value) || comparator()(r->value, l->value))
         {
             return false;
         }
+        l = successor(l);
+        r = successor(r);
     }
 
     return true;
 }
 
 // operator!= - Checks if two sets contain different elements
-template <typename T>
-bool TreeSet<T>::operator!=(const TreeSet &other) const
+template <typename T, typename Compare, typename Stats>
+bool TreeSet<T, Compare, Stats>::operator!=(const TreeSet &other) const
 {
     // Use the equality operator and return its negation
     return !(*this == other);
 }
 
-// clear() - Removes every element in the set
-template <typename T>
-void TreeSet<T>::clear()
+// clear() - Removes every element in the set and hands the node storage back in bulk
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::clear()
 {
-    std::function<void(BinaryTreeNode<T> *)> delete_subtree = [&](BinaryTreeNode<T> *node)
+    if constexpr (!std::is_trivially_destructible_v<T>)
     {
-        if (node == nullptr)
-            return;
-        delete_subtree(node->_left);  // Recursively delete left subtree
-        delete_subtree(node->_right); // Recursively delete right subtree
-        delete node;                  // Delete current node
-    };
+        // Post-order teardown without a stack: descend to a leaf, unhook and
+        // destroy it, then continue from its parent
+        BinaryTreeNode<T, Stats> *node = _root;
+        while (node != nullptr)
+        {
+            if (node->_left != nullptr)
+            {
+                node = node->_left;
+            }
+            else if (node->_right != nullptr)
+            {
+                node = node->_right;
+            }
+            else
+            {
+                BinaryTreeNode<T, Stats> *parent = node->_parent;
+                if (parent != nullptr)
+                    (parent->_left == node ? parent->_left : parent->_right) = nullptr;
+                _pool.destroy(node); // Run the value's destructor
+                node = parent;
+            }
+        }
+    }
 
-    delete_subtree(_root); // Start deleting from the root
-    _root = nullptr;       // Set root to nullptr after all nodes are deleted
-    _size = 0;             // Reset size
+    _pool.release(); // Return every slab at once
+    _root = nullptr; // Set root to nullptr after all nodes are deleted
+    _size = 0;       // Reset size
 }
 
-template <typename T>
-TreeSet<T>::~TreeSet()
+template <typename T, typename Compare, typename Stats>
+TreeSet<T, Compare, Stats>::~TreeSet()
 {
     clear();
 }
 
-template <typename T>
-void TreeSet<T>::rotate_left(BinaryTreeNode<T> *x)
+// subtree_size() - Number of nodes below and including node (order statistics only)
+template <typename T, typename Compare, typename Stats>
+size_t TreeSet<T, Compare, Stats>::subtree_size(const BinaryTreeNode<T, Stats> *node)
 {
-    BinaryTreeNode<T> *y = x->_right;
+    if constexpr (Stats::enabled)
+        return node == nullptr ? 0 : node->_subtree_size;
+    else
+        return 0;
+}
+
+// update_size() - Recomputes node's subtree size from its children; a no-op without order statistics
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::update_size(BinaryTreeNode<T, Stats> *node)
+{
+    if constexpr (Stats::enabled)
+        node->_subtree_size = subtree_size(node->_left) + subtree_size(node->_right) + 1;
+}
+
+// update_sizes_to_root() - Recomputes subtree sizes on the path from node up to the root
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::update_sizes_to_root(BinaryTreeNode<T, Stats> *node)
+{
+    if constexpr (Stats::enabled)
+    {
+        for (; node != nullptr; node = node->_parent)
+            update_size(node);
+    }
+}
+
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::rotate_left(BinaryTreeNode<T, Stats> *x)
+{
+    BinaryTreeNode<T, Stats> *y = x->_right;
     x->_right = y->_left;
 
     if (y->_left != nullptr)
@@ -333,12 +1165,15 @@ void TreeSet<T>::rotate_left(BinaryTreeNode<T> *x)
 
     y->_left = x;
     x->_parent = y;
+
+    update_size(x);
+    update_size(y);
 }
 
-template <typename T>
-void TreeSet<T>::rotate_right(BinaryTreeNode<T> *y)
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::rotate_right(BinaryTreeNode<T, Stats> *y)
 {
-    BinaryTreeNode<T> *x = y->_left;
+    BinaryTreeNode<T, Stats> *x = y->_left;
     y->_left = x->_right;
 
     if (x->_right != nullptr)
@@ -363,16 +1198,19 @@ void TreeSet<T>::rotate_right(BinaryTreeNode<T> *y)
 
     x->_right = y;
     y->_parent = x;
+
+    update_size(y);
+    update_size(x);
 }
 
-template <typename T>
-void TreeSet<T>::fix_violation(BinaryTreeNode<T> *z)
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::fix_violation(BinaryTreeNode<T, Stats> *z)
 {
     while (z != _root && z->_parent->_color == Red)
     {
         if (z->_parent == z->_parent->_parent->_left)
         {
-            BinaryTreeNode<T> *y = z->_parent->_parent->_right; // z's uncle
+            BinaryTreeNode<T, Stats> *y = z->_parent->_parent->_right; // z's uncle
             if (y && y->_color == Red)
             { // Case 1
                 z->_parent->_color = Black;
@@ -394,7 +1232,7 @@ void TreeSet<T>::fix_violation(BinaryTreeNode<T> *z)
         }
         else
         {
-            BinaryTreeNode<T> *y = z->_parent->_parent->_left; // Mirror image of above
+            BinaryTreeNode<T, Stats> *y = z->_parent->_parent->_left; // Mirror image of above
             if (y && y->_color == Red)
             {
                 z->_parent->_color = Black;
@@ -418,4 +1256,163 @@ void TreeSet<T>::fix_violation(BinaryTreeNode<T> *z)
     _root->_color = Black;
 }
 
+// transplant() - Puts subtree v in the place of subtree u under u's parent
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::transplant(BinaryTreeNode<T, Stats> *u, BinaryTreeNode<T, Stats> *v)
+{
+    if (u->_parent == nullptr)
+    {
+        _root = v;
+    }
+    else if (u == u->_parent->_left)
+    {
+        u->_parent->_left = v;
+    }
+    else
+    {
+        u->_parent->_right = v;
+    }
+
+    if (v != nullptr)
+    {
+        v->_parent = u->_parent;
+    }
+}
+
+// erase_node() - Unlinks z from the tree, repairs the colors and returns z to the pool
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::erase_node(BinaryTreeNode<T, Stats> *z)
+{
+    BinaryTreeNode<T, Stats> *y = z; // node actually removed from its position
+    Color removed_color = y->_color;
+    BinaryTreeNode<T, Stats> *x = nullptr; // node moving into y's position (may be null)
+    BinaryTreeNode<T, Stats> *x_parent = nullptr;
+
+    if (z->_left == nullptr)
+    {
+        x = z->_right;
+        x_parent = z->_parent;
+        transplant(z, z->_right);
+    }
+    else if (z->_right == nullptr)
+    {
+        x = z->_left;
+        x_parent = z->_parent;
+        transplant(z, z->_left);
+    }
+    else
+    {
+        y = leftmost(z->_right); // z's successor takes z's place
+        removed_color = y->_color;
+        x = y->_right;
+
+        if (y->_parent == z)
+        {
+            x_parent = y;
+        }
+        else
+        {
+            x_parent = y->_parent;
+            transplant(y, y->_right);
+            y->_right = z->_right;
+            y->_right->_parent = y;
+        }
+
+        transplant(z, y);
+        y->_left = z->_left;
+        y->_left->_parent = y;
+        y->_color = z->_color;
+    }
+
+    _pool.destroy(z);
+    _size--;
+    update_sizes_to_root(x_parent);
+
+    if (removed_color == Black)
+    {
+        fix_erase(x, x_parent);
+    }
+}
+
+// fix_erase() - Restores the black height after a black node was removed above x
+template <typename T, typename Compare, typename Stats>
+void TreeSet<T, Compare, Stats>::fix_erase(BinaryTreeNode<T, Stats> *x, BinaryTreeNode<T, Stats> *parent)
+{
+    auto is_black = [](BinaryTreeNode<T, Stats> *node)
+    { return node == nullptr || node->_color == Black; };
+
+    while (x != _root && is_black(x))
+    {
+        if (x == parent->_left)
+        {
+            BinaryTreeNode<T, Stats> *w = parent->_right; // x's sibling
+            if (w->_color == Red)
+            { // Case 1
+                w->_color = Black;
+                parent->_color = Red;
+                rotate_left(parent);
+                w = parent->_right;
+            }
+            if (is_black(w->_left) && is_black(w->_right))
+            { // Case 2
+                w->_color = Red;
+                x = parent;
+                parent = x->_parent;
+            }
+            else
+            {
+                if (is_black(w->_right))
+                { // Case 3
+                    w->_left->_color = Black;
+                    w->_color = Red;
+                    rotate_right(w);
+                    w = parent->_right;
+                }
+                w->_color = parent->_color; // Case 4
+                parent->_color = Black;
+                w->_right->_color = Black;
+                rotate_left(parent);
+                x = _root;
+            }
+        }
+        else
+        {
+            BinaryTreeNode<T, Stats> *w = parent->_left; // Mirror image of above
+            if (w->_color == Red)
+            {
+                w->_color = Black;
+                parent->_color = Red;
+                rotate_right(parent);
+                w = parent->_left;
+            }
+            if (is_black(w->_left) && is_black(w->_right))
+            {
+                w->_color = Red;
+                x = parent;
+                parent = x->_parent;
+            }
+            else
+            {
+                if (is_black(w->_left))
+                {
+                    w->_right->_color = Black;
+                    w->_color = Red;
+                    rotate_left(w);
+                    w = parent->_left;
+                }
+                w->_color = parent->_color;
+                parent->_color = Black;
+                w->_left->_color = Black;
+                rotate_right(parent);
+                x = _root;
+            }
+        }
+    }
+
+    if (x != nullptr)
+    {
+        x->_color = Black;
+    }
+}
+
 #endif
@@ -0,0 +1,300 @@
+#ifndef TREE_SET_HPP
+#define TREE_SET_HPP
+
+#include "BinaryTreeNode.hpp"
+#include "NodePool.hpp"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Holds a comparator; empty comparators such as std::less take no space
+// thanks to the empty base optimization. Containers copy it when they are
+// moved from, so the source stays usable, which makes their moves noexcept
+// only when that copy is: a ThreeWayComparator copy can throw. They copy it
+// before giving up any nodes, so a throw leaves both containers as they were.
+template <typename Compare, bool = std::is_empty_v<Compare> && !std::is_final_v<Compare>>
+class ComparatorStorage
+{
+private:
+    Compare _compare;
+
+public:
+    ComparatorStorage(const Compare &compare) : _compare(compare) {}
+    const Compare &comparator() const { return _compare; }
+};
+
+template <typename Compare>
+class ComparatorStorage<Compare, true> : private Compare
+{
+public:
+    ComparatorStorage(const Compare &compare) : Compare(compare) {}
+    const Compare &comparator() const { return *this; }
+};
+
+// Type-erased comparator for orderings only known at runtime. Wraps a
+// function returning a negative, zero or positive int, and is opted into
+// with TreeSet<T, ThreeWayComparator<T>>.
+template <typename T>
+class ThreeWayComparator
+{
+private:
+    std::function<int(const T &, const T &)> _comparator;
+
+public:
+    ThreeWayComparator()
+        : _comparator([](const T &left, const T &right)
+                      { return left < right ? -1 : (right < left ? 1 : 0); }) {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, ThreeWayComparator>>>
+    ThreeWayComparator(F comparator) : _comparator(std::move(comparator)) {}
+
+    bool operator()(const T &left, const T &right) const { return _comparator(left, right) < 0; }
+};
+
+template <typename T, typename Compare = std::less<T>, typename Stats = NoOrderStatistics>
+class TreeSet : private ComparatorStorage<Compare>
+{
+private:
+    enum class SetOperation
+    {
+        Union,
+        Intersection,
+        Difference,
+        SymmetricDifference
+    };
+
+    BinaryTreeNode<T, Stats> *_root;
+    size_t _size;
+    NodePool<BinaryTreeNode<T, Stats>> _pool;
+
+    using ComparatorStorage<Compare>::comparator;
+
+    template <typename K>
+    BinaryTreeNode<T, Stats> *find_node(const K &key) const;
+    template <typename K>
+    BinaryTreeNode<T, Stats> *lower_bound_node(const K &key) const;
+    template <typename K>
+    BinaryTreeNode<T, Stats> *upper_bound_node(const K &key) const;
+
+    template <typename NextNode>
+    BinaryTreeNode<T, Stats> *link_sorted(size_t count, size_t depth, size_t red_depth, BinaryTreeNode<T, Stats> *parent,
+                                   NextNode &next_node);
+    template <typename NextNode>
+    void build_sorted(size_t count, NextNode &next_node);
+    template <typename InputIt>
+    void build_sorted(InputIt first, size_t count);
+    void load(const std::vector<T> &items);
+
+    template <typename K, typename... Args>
+    std::pair<BinaryTreeNode<T, Stats> *, bool> insert_unique(const K &key, Args &&...args);
+    template <typename K, typename Visit>
+    void search_batch(const std::vector<K> &keys, Visit visit) const;
+
+    static BinaryTreeNode<T, Stats> *leftmost(BinaryTreeNode<T, Stats> *node);
+    static BinaryTreeNode<T, Stats> *rightmost(BinaryTreeNode<T, Stats> *node);
+    static BinaryTreeNode<T, Stats> *successor(BinaryTreeNode<T, Stats> *node);
+    static BinaryTreeNode<T, Stats> *predecessor(BinaryTreeNode<T, Stats> *node);
+    void merge_into(const TreeSet &left, const TreeSet &right, SetOperation operation);
+
+    BinaryTreeNode<T, Stats> *clone_subtree(const BinaryTreeNode<T, Stats> *node, BinaryTreeNode<T, Stats> *parent);
+    int black_height(const BinaryTreeNode<T, Stats> *node) const;
+
+    void rotate_left(BinaryTreeNode<T, Stats> *x);
+    void rotate_right(BinaryTreeNode<T, Stats> *y);
+    void fix_violation(BinaryTreeNode<T, Stats> *z);
+    void transplant(BinaryTreeNode<T, Stats> *u, BinaryTreeNode<T, Stats> *v);
+    void erase_node(BinaryTreeNode<T, Stats> *z);
+    void fix_erase(BinaryTreeNode<T, Stats> *x, BinaryTreeNode<T, Stats> *parent);
+
+    static size_t subtree_size(const BinaryTreeNode<T, Stats> *node);
+    static void update_size(BinaryTreeNode<T, Stats> *node);
+    static void update_sizes_to_root(BinaryTreeNode<T, Stats> *node);
+
+public:
+    // Bidirectional in-order iterator. Walks the _parent links, so a scan needs
+    // no extra memory; end() is the null node and steps back to the maximum.
+    class const_iterator
+    {
+    private:
+        friend class TreeSet;
+
+        BinaryTreeNode<T, Stats> *_node;
+        const TreeSet *_tree;
+
+        const_iterator(BinaryTreeNode<T, Stats> *node, const TreeSet *tree) : _node(node), _tree(tree) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : _node(nullptr), _tree(nullptr) {}
+
+        reference operator*() const { return _node->value; }
+        pointer operator->() const { return &_node->value; }
+
+        const_iterator &operator++()
+        {
+            _node = successor(_node);
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        const_iterator &operator--()
+        {
+            _node = _node == nullptr ? rightmost(_tree->_root) : predecessor(_node);
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const { return _node == other._node; }
+        bool operator!=(const const_iterator &other) const { return _node != other._node; }
+    };
+
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+    TreeSet();
+    explicit TreeSet(std::pmr::memory_resource *resource);
+    explicit TreeSet(const Compare &comparator,
+                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    TreeSet(const std::vector<T> &items);
+    TreeSet(const std::vector<T> &items, const Compare &comparator,
+            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    TreeSet(const TreeSet &other);
+    // Moves hand over the nodes together with the pool they came from
+    TreeSet(TreeSet &&other) noexcept(std::is_nothrow_copy_constructible_v<Compare>);
+    TreeSet &operator=(const TreeSet &other);
+    TreeSet &operator=(TreeSet &&other) noexcept(std::is_nothrow_copy_assignable_v<Compare>);
+    ~TreeSet();
+
+    // from_sorted_range() - Builds a set in linear time from strictly ascending input
+    template <typename InputIt>
+    static TreeSet from_sorted_range(InputIt first, InputIt last, const Compare &comparator = Compare(),
+                                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    size_t size() const;
+    bool is_empty() const;
+    bool is_balanced() const;
+    Compare key_comp() const;
+
+    // add() - Adds value, replacing an equivalent element if present
+    void add(T value);
+
+    // insert() - Adds value unless an equivalent element is present; like std::set::insert
+    std::pair<const_iterator, bool> insert(const T &value);
+    std::pair<const_iterator, bool> insert(T &&value);
+    // emplace() - Builds a value from args, then inserts it as insert() does
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(Args &&...args);
+    // try_emplace() - Builds an element from args only if nothing equivalent to key is present
+    template <typename K, typename... Args>
+    std::pair<const_iterator, bool> try_emplace(const K &key, Args &&...args);
+
+    // remove() - Deletes the element equivalent to value; returns whether one was found
+    bool remove(const T &value);
+    // erase() - Deletes the element(s) at position or in [first, last); returns the iterator after them
+    const_iterator erase(const_iterator position);
+    const_iterator erase(const_iterator first, const_iterator last);
+    bool contains(const T &value) const;
+    std::optional<T> get(const T &value) const;
+    const T *find(const T &value) const;
+    std::optional<T> min() const;
+    std::optional<T> max() const;
+    std::vector<T> to_vector() const;
+
+    // Batched lookups: results line up with values. The searches run
+    // interleaved so their cache misses overlap instead of queueing up.
+    std::vector<bool> contains_batch(const std::vector<T> &values) const;
+    std::vector<std::optional<T>> get_batch(const std::vector<T> &values) const;
+    std::vector<const T *> find_batch(const std::vector<T> &values) const;
+
+    // Order statistics, available with TreeSet<T, Compare, OrderStatistics>; all O(log n).
+    // select() - Iterator to the k-th smallest element (0-based), or end() if k >= size()
+    template <typename S = Stats, typename = std::enable_if_t<S::enabled>>
+    const_iterator select(size_t k) const;
+    // rank() - Number of elements ordered before value
+    template <typename S = Stats, typename = std::enable_if_t<S::enabled>>
+    size_t rank(const T &value) const;
+    // count_range() - Number of elements in [lo, hi)
+    template <typename S = Stats, typename = std::enable_if_t<S::enabled>>
+    size_t count_range(const T &lo, const T &hi) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    // lower_bound() - First element not ordered before value; upper_bound() - first ordered after it
+    const_iterator lower_bound(const T &value) const;
+    const_iterator upper_bound(const T &value) const;
+    std::pair<const_iterator, const_iterator> equal_range(const T &value) const;
+
+    // Lookups by any key the comparator can order against T; only
+    // available when Compare declares is_transparent.
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::optional<T> get(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const T *find(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::vector<const T *> find_batch(const std::vector<K> &keys) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const K &key);
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const K &key) const;
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+    // Set algebra runs as a linear merge of both in-order sequences. Overloads
+    // taking a temporary rebuild the result out of that temporary's nodes;
+    // elements equivalent under the comparator are taken from the right operand
+    // for +, and from the left one for &.
+    TreeSet operator+(const TreeSet &other) const &;
+    TreeSet operator+(const TreeSet &other) &&;
+    TreeSet operator+(TreeSet &&other) const &;
+    TreeSet operator+(TreeSet &&other) &&;
+    TreeSet &operator+=(const TreeSet &other);
+
+    TreeSet operator&(const TreeSet &other) const &;
+    TreeSet operator&(const TreeSet &other) &&;
+    TreeSet operator&(TreeSet &&other) const &;
+    TreeSet operator&(TreeSet &&other) &&;
+
+    TreeSet operator-(const TreeSet &other) const &;
+    TreeSet operator-(const TreeSet &other) &&;
+    TreeSet operator-(TreeSet &&other) const &;
+    TreeSet operator-(TreeSet &&other) &&;
+
+    TreeSet operator^(const TreeSet &other) const &;
+    TreeSet operator^(const TreeSet &other) &&;
+    TreeSet operator^(TreeSet &&other) const &;
+    TreeSet operator^(TreeSet &&other) &&;
+
+    bool operator==(const TreeSet &other) const;
+    bool operator!=(const TreeSet &other) const;
+
+    void clear();
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "BTreeMap.cpp"
+#include <map>
+#include <random>
+
+TEST(BTreeMapTest, InsertAndRetrieve)
+{
+    BTreeMap<int, int> map;
+    map.insert(1, 100);
+    map.insert(2, 200);
+    map.insert(1, 150);
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.get(1), std::optional<int>(150));
+    ASSERT_EQ(map.get(3), std::nullopt);
+    ASSERT_TRUE(map.contains(2));
+}
+
+TEST(BTreeMapTest, FindAndIterate)
+{
+    BTreeMap<std::string, std::vector<int>> map({{"b", {2}}, {"a", {1}}});
+
+    map.find("a")->push_back(10);
+    ASSERT_EQ(map.get("a"), std::optional<std::vector<int>>({1, 10}));
+    ASSERT_EQ(map.find("c"), nullptr);
+
+    std::string keys;
+    for (auto [key, value] : map)
+        keys += key;
+    ASSERT_EQ(keys, "ab");
+    ASSERT_EQ(map.begin()->second.size(), 2);
+}
+
+TEST(BTreeMapTest, MatchesStdMap)
+{
+    std::mt19937 rng(11);
+    BTreeMap<int, int> map;
+    std::map<int, int> reference;
+
+    for (int i = 0; i < 30000; i++)
+    {
+        int k = rng() % 5000;
+        if (rng() % 3)
+        {
+            map.insert(k, i);
+            reference[k] = i;
+        }
+        else
+        {
+            ASSERT_EQ(map.erase(k), reference.erase(k) == 1);
+        }
+    }
+
+    std::vector<std::pair<int, int>> expected(reference.begin(), reference.end());
+    ASSERT_EQ(map.to_vector(), expected);
+}
+
+TEST(BTreeMapTest, FromSortedRange)
+{
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 5000; i++)
+        items.push_back({i, -i});
+
+    auto map = BTreeMap<int, int>::from_sorted_range(items.begin(), items.end());
+    ASSERT_EQ(map.size(), 5000);
+    ASSERT_EQ(map.get(4321), std::optional<int>(-4321));
+    ASSERT_EQ(map.to_vector(), items);
+}
+
+TEST(BTreeMapTest, VectorConstructorAndIteratorErase)
+{
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 4000; i++)
+        items.push_back({i, i * i});
+    BTreeMap<int, int> map(items);
+    ASSERT_EQ(map.to_vector(), items);
+    ASSERT_TRUE(map.is_balanced());
+
+    // A repeated key keeps its last value
+    BTreeMap<int, int> repeated({{2, 1}, {1, 1}, {2, 7}});
+    ASSERT_EQ(repeated.get(2), std::optional<int>(7));
+
+    auto range = map.equal_range(100);
+    ASSERT_EQ(range.first.key(), 100);
+    ASSERT_EQ(range.second.key(), 101);
+    auto next = map.erase(range.first);
+    ASSERT_EQ(next.key(), 101);
+    next = map.erase(map.lower_bound(1000), map.lower_bound(3000));
+    ASSERT_EQ(next.key(), 3000);
+    ASSERT_EQ(map.size(), 4000 - 1 - 2000);
+    ASSERT_FALSE(map.contains(2999));
+    ASSERT_TRUE(map.erase(3000));
+    ASSERT_TRUE(map.is_balanced());
+}
+
+TEST(BTreeMapTest, HeterogeneousLookup)
+{
+    BTreeMap<std::string, int, std::less<>> map;
+    map.insert("alpha", 1);
+    map.insert("beta", 2);
+
+    std::string_view key = "beta";
+    ASSERT_TRUE(map.contains(key));
+    ASSERT_EQ(map.get(key), std::optional<int>(2));
+    *map.find(key) = 5;
+    const auto &view = map;
+    ASSERT_EQ(*view.find(key), 5);
+    ASSERT_EQ(map.find(std::string_view("gamma")), nullptr);
+}
@@ -0,0 +1,240 @@
+#include "BTreeSet.cpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+
+TEST(BTreeSetTest, InstantiateEmptySet)
+{
+    BTreeSet<int> s;
+
+    ASSERT_EQ(s.size(), 0);
+    ASSERT_TRUE(s.is_empty());
+    ASSERT_EQ(s.min(), std::nullopt);
+    ASSERT_TRUE(s.begin() == s.end());
+}
+
+TEST(BTreeSetTest, AddContainsGet)
+{
+    BTreeSet<int> s({5, 3, 8, 1});
+    s.add(3);
+
+    ASSERT_EQ(s.size(), 4);
+    ASSERT_TRUE(s.contains(8));
+    ASSERT_FALSE(s.contains(7));
+    ASSERT_EQ(s.get(5), std::optional<int>(5));
+    ASSERT_EQ(s.find(2), nullptr);
+    ASSERT_EQ(s.min(), 1);
+    ASSERT_EQ(s.max(), 8);
+    ASSERT_EQ(s.to_vector(), std::vector<int>({1, 3, 5, 8}));
+}
+
+TEST(BTreeSetTest, ManySplitsMatchStdSet)
+{
+    std::mt19937 rng(9);
+    BTreeSet<long long> s;
+    std::set<long long> reference;
+
+    for (int i = 0; i < 50000; i++)
+    {
+        long long k = rng() % 20000;
+        if (rng() % 4)
+        {
+            s.add(k);
+            reference.insert(k);
+        }
+        else
+        {
+            ASSERT_EQ(s.remove(k), reference.erase(k) == 1);
+        }
+    }
+
+    ASSERT_EQ(s.size(), reference.size());
+    ASSERT_TRUE(s.is_balanced());
+    ASSERT_EQ(s.to_vector(), std::vector<long long>(reference.begin(), reference.end()));
+    for (long long k = -1; k < 20001; k += 7)
+    {
+        ASSERT_EQ(s.contains(k), reference.count(k) == 1);
+        auto lower = s.lower_bound(k);
+        auto expected = reference.lower_bound(k);
+        ASSERT_EQ(lower == s.end(), expected == reference.end());
+        if (expected != reference.end())
+        {
+            ASSERT_EQ(*lower, *expected);
+        }
+    }
+    ASSERT_EQ(std::vector<long long>(s.rbegin(), s.rend()), std::vector<long long>(reference.rbegin(), reference.rend()));
+}
+
+TEST(BTreeSetTest, StringsAndDescendingOrder)
+{
+    BTreeSet<std::string> words;
+    for (int i = 0; i < 2000; i++)
+        words.add("w" + std::to_string(i));
+    ASSERT_EQ(words.size(), 2000);
+    ASSERT_TRUE(words.contains("w1999"));
+    ASSERT_EQ(*words.upper_bound("w1"), "w10");
+
+    BTreeSet<int, std::greater<int>> descending;
+    for (int i = 0; i < 1000; i++)
+        descending.add(i);
+    ASSERT_EQ(descending.min(), 999);
+    ASSERT_EQ(*descending.lower_bound(500), 500);
+    ASSERT_EQ(*descending.upper_bound(500), 499);
+}
+
+TEST(BTreeSetTest, FromSortedRangeAndCopy)
+{
+    std::vector<int> items;
+    for (int i = 0; i < 10000; i += 2)
+        items.push_back(i);
+
+    auto s = BTreeSet<int>::from_sorted_range(items.begin(), items.end());
+    ASSERT_EQ(s.to_vector(), items);
+
+    BTreeSet<int> copy(s);
+    copy.add(1);
+    ASSERT_TRUE(copy.contains(1));
+    ASSERT_FALSE(s.contains(1));
+    ASSERT_EQ(copy.size(), s.size() + 1);
+
+    for (int value : items)
+        copy.remove(value);
+    ASSERT_EQ(copy.to_vector(), std::vector<int>({1}));
+}
+
+TEST(BTreeSetTest, ShrinkingMergesNodes)
+{
+    BTreeSet<long long> s;
+    for (long long i = 0; i < 200000; i++)
+        s.add(i);
+
+    // Remove from both ends and the middle, checking the fill as it shrinks
+    std::mt19937 rng(9);
+    std::vector<long long> order(200000);
+    for (long long i = 0; i < 200000; i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    for (size_t i = 0; i + 3 < order.size(); i++)
+    {
+        ASSERT_TRUE(s.remove(order[i]));
+        if (i % 10000 == 0)
+        {
+            ASSERT_TRUE(s.is_balanced());
+        }
+    }
+
+    // Non-root nodes stay half full, so three elements fit in the root leaf
+    ASSERT_EQ(s.size(), 3);
+    ASSERT_TRUE(s.is_balanced());
+    std::vector<long long> rest(order.end() - 3, order.end());
+    std::sort(rest.begin(), rest.end());
+    ASSERT_EQ(s.to_vector(), rest);
+    ASSERT_EQ(s.min(), rest.front());
+    ASSERT_EQ(s.max(), rest.back());
+    ASSERT_EQ(std::next(s.begin(), 3), s.end());
+}
+
+TEST(BTreeSetTest, VectorConstructorBulkLoadsSortedInput)
+{
+    std::vector<int> sorted;
+    for (int i = 0; i < 5000; i++)
+        sorted.push_back(i * 3);
+    BTreeSet<int> s(sorted);
+    ASSERT_EQ(s.to_vector(), sorted);
+    ASSERT_TRUE(s.is_balanced());
+
+    BTreeSet<int> unsorted({5, 1, 5, 3});
+    ASSERT_EQ(unsorted.to_vector(), std::vector<int>({1, 3, 5}));
+
+    BTreeSet<int, std::greater<int>> descending({9, 4, 1}, std::greater<int>());
+    ASSERT_EQ(descending.to_vector(), std::vector<int>({9, 4, 1}));
+    ASSERT_TRUE(descending.key_comp()(9, 4));
+}
+
+TEST(BTreeSetTest, SetAlgebra)
+{
+    BTreeSet<int> evens;
+    BTreeSet<int> threes;
+    for (int i = 0; i < 3000; i++)
+    {
+        if (i % 2 == 0)
+            evens.add(i);
+        if (i % 3 == 0)
+            threes.add(i);
+    }
+
+    std::vector<int> both, either, only_evens, exactly_one;
+    for (int i = 0; i < 3000; i++)
+    {
+        bool even = i % 2 == 0;
+        bool three = i % 3 == 0;
+        if (even && three)
+            both.push_back(i);
+        if (even || three)
+            either.push_back(i);
+        if (even && !three)
+            only_evens.push_back(i);
+        if (even != three)
+            exactly_one.push_back(i);
+    }
+    ASSERT_EQ((evens & threes).to_vector(), both);
+    ASSERT_EQ((evens + threes).to_vector(), either);
+    ASSERT_EQ((evens - threes).to_vector(), only_evens);
+    ASSERT_EQ((evens ^ threes).to_vector(), exactly_one);
+    ASSERT_TRUE((evens + threes).is_balanced());
+
+    BTreeSet<int> sum(evens);
+    sum += threes;
+    ASSERT_TRUE(sum == evens + threes);
+    ASSERT_TRUE(sum != evens);
+    ASSERT_TRUE((evens - evens) == BTreeSet<int>());
+}
+
+TEST(BTreeSetTest, IteratorEraseAndHeterogeneousLookup)
+{
+    BTreeSet<std::string, std::less<>> words;
+    for (int i = 0; i < 1000; i++)
+        words.add("w" + std::to_string(1000 + i));
+
+    std::string_view key = "w1500";
+    ASSERT_TRUE(words.contains(key));
+    ASSERT_EQ(words.get(key), std::optional<std::string>("w1500"));
+    ASSERT_EQ(*words.find(key), "w1500");
+    auto range = words.equal_range(key);
+    ASSERT_EQ(*range.first, "w1500");
+    ASSERT_EQ(*range.second, "w1501");
+    ASSERT_TRUE(words.remove(key));
+    ASSERT_EQ(words.find(key), nullptr);
+    ASSERT_EQ(*words.lower_bound(key), "w1501");
+
+    auto next = words.erase(words.lower_bound(std::string_view("w1100")));
+    ASSERT_EQ(*next, "w1101");
+    next = words.erase(words.lower_bound(std::string_view("w1200")), words.lower_bound(std::string_view("w1800")));
+    ASSERT_EQ(*next, "w1800");
+    ASSERT_EQ(words.size(), 1000 - 2 - 599);
+    ASSERT_TRUE(words.is_balanced());
+
+    words.erase(words.lower_bound(std::string_view("w1900")), words.end());
+    ASSERT_EQ(words.max(), std::optional<std::string>("w1899"));
+    ASSERT_EQ(words.erase(words.begin(), words.end()), words.end());
+    ASSERT_TRUE(words.is_empty());
+}
+
+TEST(BTreeSetTest, MoveIsNoexceptOnlyWhenTheComparatorCopyIs)
+{
+    static_assert(std::is_nothrow_move_constructible_v<BTreeSet<int>>);
+    static_assert(std::is_nothrow_move_assignable_v<BTreeSet<int>>);
+    static_assert(!std::is_nothrow_move_constructible_v<BTreeSet<int, ThreeWayComparator<int>>>);
+    static_assert(!std::is_nothrow_move_assignable_v<BTreeSet<int, ThreeWayComparator<int>>>);
+
+    // A moved-from set keeps a working comparator
+    BTreeSet<int, ThreeWayComparator<int>> s;
+    s.add(2);
+    BTreeSet<int, ThreeWayComparator<int>> moved(std::move(s));
+    s.add(1);
+    s.add(3);
+    ASSERT_EQ(s.to_vector(), std::vector<int>({1, 3}));
+    moved = std::move(s);
+    ASSERT_EQ(moved.to_vector(), std::vector<int>({1, 3}));
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "ConcurrentTreeMap.cpp"
+#include <thread>
+
+TEST(ConcurrentTreeMapTest, BasicOperations)
+{
+    ConcurrentTreeMap<int, std::string> map;
+    map.insert(1, "one");
+    map.insert(2, "two");
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.get(1), std::optional<std::string>("one"));
+    ASSERT_TRUE(map.contains(2));
+    ASSERT_TRUE(map.erase(2));
+    ASSERT_FALSE(map.contains(2));
+
+    size_t length = 0;
+    ASSERT_TRUE(map.visit(1, [&](const std::string &value)
+                          { length = value.size(); }));
+    ASSERT_EQ(length, 3);
+    ASSERT_TRUE(map.update(1, [](std::string &value)
+                           { value += "!"; }));
+    ASSERT_EQ(map.get(1), std::optional<std::string>("one!"));
+    ASSERT_FALSE(map.update(5, [](std::string &) {}));
+}
+
+TEST(ConcurrentTreeMapTest, ReadersAndWritersInParallel)
+{
+    ConcurrentTreeMap<int, int> map;
+    for (int i = 0; i < 1000; i++)
+        map.insert(i, i);
+
+    std::vector<std::thread> threads;
+    std::atomic<bool> mismatch{false};
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int round = 0; round < 20000; round++)
+            {
+                int key = round % 1000;
+                auto value = map.get(key);
+                if (!value || (*value != key && *value != -key))
+                    mismatch = true;
+            } });
+    }
+    threads.emplace_back([&]()
+                         {
+        for (int i = 0; i < 1000; i++)
+            map.insert(i, -i);
+        for (int i = 1000; i < 2000; i++)
+            map.insert(i, i); });
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    ASSERT_FALSE(mismatch);
+    ASSERT_EQ(map.size(), 2000);
+    ASSERT_EQ(map.get(500), std::optional<int>(-500));
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "MappedTreeMap.cpp"
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+static std::string snapshot_path(const std::string &name)
+{
+    return testing::TempDir() + name;
+}
+
+TEST(MappedTreeMapTest, RoundTripsATreeMap)
+{
+    TreeMap<int64_t, double> map;
+    for (int64_t i = 0; i < 10000; i++)
+        map.insert(i * 2, i * 0.5);
+
+    std::string path = snapshot_path("roundtrip.snapshot");
+    MappedTreeMap<int64_t, double>::write(path, map);
+    MappedTreeMap<int64_t, double> mapped(path);
+
+    ASSERT_EQ(mapped.size(), 10000);
+    for (int64_t i = 0; i < 10000; i++)
+    {
+        ASSERT_EQ(mapped.get(i * 2), std::optional<double>(i * 0.5));
+        ASSERT_FALSE(mapped.contains(i * 2 + 1));
+    }
+    ASSERT_FALSE(mapped.contains(-1));
+    ASSERT_EQ(mapped.find(20000), nullptr);
+    ASSERT_EQ(mapped.to_vector(), map.to_vector());
+    std::remove(path.c_str());
+}
+
+TEST(MappedTreeMapTest, RangeAndBounds)
+{
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 3000; i++)
+        entries.push_back({i * 10, i});
+
+    std::string path = snapshot_path("range.snapshot");
+    MappedTreeMap<int, int>::write(path, entries.begin(), entries.end());
+    MappedTreeMap<int, int> mapped(path);
+
+    auto [first, last] = mapped.range(10235, 10300);
+    std::vector<int> keys;
+    for (auto it = first; it != last; ++it)
+        keys.push_back(it->first);
+    ASSERT_EQ(keys, std::vector<int>({10240, 10250, 10260, 10270, 10280, 10290}));
+
+    ASSERT_EQ(mapped.lower_bound(10240).key(), 10240);
+    ASSERT_EQ(mapped.upper_bound(10240).key(), 10250);
+    ASSERT_EQ(mapped.lower_bound(-5).key(), 0);
+    ASSERT_TRUE(mapped.lower_bound(30000) == mapped.end());
+    ASSERT_TRUE(mapped.range(500, 100).first == mapped.range(500, 100).second);
+    std::remove(path.c_str());
+}
+
+TEST(MappedTreeMapTest, EmptySnapshot)
+{
+    std::string path = snapshot_path("empty.snapshot");
+    MappedTreeMap<int, int>::write(path, TreeMap<int, int>());
+    MappedTreeMap<int, int> mapped(path);
+
+    ASSERT_TRUE(mapped.is_empty());
+    ASSERT_FALSE(mapped.contains(0));
+    ASSERT_TRUE(mapped.begin() == mapped.end());
+    std::remove(path.c_str());
+}
+
+TEST(MappedTreeMapTest, RejectsBadInputAndFiles)
+{
+    std::string path = snapshot_path("bad.snapshot");
+
+    MappedTreeMap<int, int>::Writer writer(path);
+    writer.append(1, 1);
+    ASSERT_THROW(writer.append(1, 2), std::invalid_argument);
+    writer.finish();
+
+    ASSERT_THROW((MappedTreeMap<int64_t, int>(path)), std::runtime_error);
+    ASSERT_THROW((MappedTreeMap<int, int>(snapshot_path("missing.snapshot"))), std::runtime_error);
+
+    MappedTreeMap<int, int>::Writer unfinished(path);
+    unfinished.append(1, 1);
+    ASSERT_THROW((MappedTreeMap<int, int>(path)), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(MappedTreeMapTest, WritesWithTheMapsOwnComparator)
+{
+    // A runtime descending order; a default-constructed comparator would be ascending
+    ThreeWayComparator<int> descending([](const int &left, const int &right)
+                                       { return right - left; });
+    TreeMap<int, int, ThreeWayComparator<int>> map(descending);
+    for (int i = 0; i < 1000; i++)
+        map.insert(i, -i);
+    ASSERT_TRUE(map.key_comp()(2, 1));
+
+    std::string path = snapshot_path("descending.snapshot");
+    MappedTreeMap<int, int, ThreeWayComparator<int>>::write(path, map);
+    MappedTreeMap<int, int, ThreeWayComparator<int>> mapped(path, descending);
+
+    ASSERT_EQ(mapped.to_vector(), map.to_vector());
+    ASSERT_EQ(mapped.to_vector().front().first, 999);
+    ASSERT_EQ(mapped.get(250), std::optional<int>(-250));
+    ASSERT_FALSE(mapped.contains(1000));
+    std::remove(path.c_str());
+}
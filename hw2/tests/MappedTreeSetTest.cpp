@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "MappedTreeSet.cpp"
+#include <cstdio>
+
+TEST(MappedTreeSetTest, RoundTripsATreeSet)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 5000; i++)
+        values.push_back(i * 3);
+    TreeSet<int, std::greater<int>> set(values, std::greater<int>());
+
+    std::string path = testing::TempDir() + "set.snapshot";
+    MappedTreeSet<int, std::greater<int>>::write(path, set);
+    MappedTreeSet<int, std::greater<int>> mapped(path);
+
+    ASSERT_EQ(mapped.size(), 5000);
+    ASSERT_TRUE(mapped.contains(300));
+    ASSERT_FALSE(mapped.contains(301));
+    ASSERT_EQ(mapped.get(3), std::optional<int>(3));
+    ASSERT_EQ(mapped.min(), std::optional<int>(14997));
+    ASSERT_EQ(mapped.max(), std::optional<int>(0));
+    ASSERT_EQ(mapped.to_vector(), set.to_vector());
+    ASSERT_EQ(*mapped.lower_bound(10), 9);
+    std::remove(path.c_str());
+}
+
+TEST(MappedTreeSetTest, MoveIsNoexceptOnlyWhenTheComparatorCopyIs)
+{
+    static_assert(std::is_nothrow_move_constructible_v<MappedTreeSet<int>>);
+    static_assert(std::is_nothrow_move_assignable_v<MappedTreeSet<int>>);
+    static_assert(!std::is_nothrow_move_constructible_v<MappedTreeSet<int, ThreeWayComparator<int>>>);
+    static_assert(!std::is_nothrow_move_assignable_v<MappedTreeSet<int, ThreeWayComparator<int>>>);
+
+    std::string path = testing::TempDir() + "moved.snapshot";
+    MappedTreeSet<int>::write(path, TreeSet<int>({1, 2, 3}));
+    MappedTreeSet<int> mapped(path);
+    MappedTreeSet<int> moved(std::move(mapped));
+    ASSERT_EQ(moved.to_vector(), std::vector<int>({1, 2, 3}));
+    std::remove(path.c_str());
+}
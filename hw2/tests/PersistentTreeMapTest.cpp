@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "PersistentTreeMap.cpp"
+#include <atomic>
+#include <thread>
+
+TEST(PersistentTreeMapTest, InsertGetErase)
+{
+    PersistentTreeMap<std::string, int> map;
+    map.insert("one", 1);
+    map.insert("two", 2);
+    map.insert("one", 11);
+
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(map.get("one"), std::optional<int>(11));
+    ASSERT_TRUE(map.erase("two"));
+    ASSERT_FALSE(map.contains("two"));
+    ASSERT_EQ(map.get("two"), std::nullopt);
+}
+
+TEST(PersistentTreeMapTest, SnapshotKeepsOldValues)
+{
+    PersistentTreeMap<int, int> map({{1, 10}, {2, 20}});
+    PersistentTreeMap<int, int> snapshot = map.snapshot();
+    map.insert(1, 100);
+    map.erase(2);
+    map.clear();
+
+    ASSERT_TRUE(map.is_empty());
+    std::vector<std::pair<int, int>> expected = {{1, 10}, {2, 20}};
+    ASSERT_EQ(snapshot.to_vector(), expected);
+}
+
+TEST(PersistentTreeMapTest, SnapshotsWhileWriting)
+{
+    PersistentTreeMap<int, int> map;
+    std::atomic<bool> done{false};
+    std::atomic<bool> inconsistent{false};
+
+    // Keys are inserted in order, so every snapshot must hold exactly 0..size-1
+    std::thread reader([&]()
+                       {
+        while (!done)
+        {
+            PersistentTreeMap<int, int> snapshot = map.snapshot();
+            int expected = 0;
+            for (const std::pair<int, int> &entry : snapshot)
+            {
+                if (entry.first != expected || entry.second != expected * 2)
+                    inconsistent = true;
+                expected++;
+            }
+            if (static_cast<size_t>(expected) != snapshot.size())
+                inconsistent = true;
+        } });
+
+    for (int i = 0; i < 5000; i++)
+        map.insert(i, i * 2);
+    done = true;
+    reader.join();
+
+    ASSERT_FALSE(inconsistent);
+    ASSERT_EQ(map.size(), 5000);
+}
+
+// Counts copies so a test can check how often get() duplicates a value
+struct CopyCounter
+{
+    static inline int copies = 0;
+    std::string text;
+
+    CopyCounter(std::string text) : text(std::move(text)) {}
+    CopyCounter(const CopyCounter &other) : text(other.text) { copies++; }
+    CopyCounter(CopyCounter &&other) noexcept = default;
+    CopyCounter &operator=(const CopyCounter &other)
+    {
+        text = other.text;
+        copies++;
+        return *this;
+    }
+    CopyCounter &operator=(CopyCounter &&other) noexcept = default;
+};
+
+TEST(PersistentTreeMapTest, GetCopiesTheValueOnce)
+{
+    PersistentTreeMap<std::string, CopyCounter> map;
+    map.insert("key", CopyCounter("payload"));
+
+    CopyCounter::copies = 0;
+    std::optional<CopyCounter> value = map.get("key");
+    ASSERT_EQ(value->text, "payload");
+    ASSERT_EQ(CopyCounter::copies, 1);
+    ASSERT_FALSE(map.get("missing").has_value());
+}
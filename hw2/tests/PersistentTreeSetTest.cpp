@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "PersistentTreeSet.cpp"
+#include <random>
+#include <set>
+
+TEST(PersistentTreeSetTest, AddRemoveContains)
+{
+    PersistentTreeSet<int> set({5, 3, 8});
+    ASSERT_TRUE(set.add(1));
+    ASSERT_FALSE(set.add(5));
+    ASSERT_EQ(set.size(), 4);
+    ASSERT_TRUE(set.contains(3));
+    ASSERT_TRUE(set.remove(3));
+    ASSERT_FALSE(set.remove(3));
+    ASSERT_FALSE(set.contains(3));
+    ASSERT_EQ(set.min(), std::optional<int>(1));
+    ASSERT_EQ(set.max(), std::optional<int>(8));
+    ASSERT_EQ(set.to_vector(), std::vector<int>({1, 5, 8}));
+}
+
+TEST(PersistentTreeSetTest, SnapshotIsUnaffectedByLaterWrites)
+{
+    PersistentTreeSet<int> set;
+    for (int i = 0; i < 100; i++)
+        set.add(i);
+
+    PersistentTreeSet<int> snapshot = set.snapshot();
+    PersistentTreeSet<int>::const_iterator it = set.begin();
+    for (int i = 0; i < 100; i += 2)
+        set.remove(i);
+    set.add(1000);
+
+    ASSERT_EQ(snapshot.size(), 100);
+    ASSERT_TRUE(snapshot.contains(0));
+    ASSERT_FALSE(snapshot.contains(1000));
+    ASSERT_EQ(set.size(), 51);
+    ASSERT_FALSE(set.contains(0));
+
+    // An iterator keeps walking the version it started on
+    int expected = 0;
+    for (; it != set.end(); ++it)
+        ASSERT_EQ(*it, expected++);
+    ASSERT_EQ(expected, 100);
+}
+
+TEST(PersistentTreeSetTest, RandomOperationsStayBalanced)
+{
+    std::mt19937 rng(11);
+    PersistentTreeSet<int> set;
+    std::set<int> reference;
+    std::vector<std::pair<PersistentTreeSet<int>, std::vector<int>>> versions;
+
+    for (int step = 0; step < 4000; step++)
+    {
+        int value = static_cast<int>(rng() % 500);
+        if (rng() % 3 == 0)
+            ASSERT_EQ(set.remove(value), reference.erase(value) == 1);
+        else
+            ASSERT_EQ(set.add(value), reference.insert(value).second);
+
+        ASSERT_TRUE(set.is_balanced());
+        if (step % 500 == 0)
+            versions.push_back({set.snapshot(), std::vector<int>(reference.begin(), reference.end())});
+    }
+
+    ASSERT_EQ(set.size(), reference.size());
+    ASSERT_EQ(set.to_vector(), std::vector<int>(reference.begin(), reference.end()));
+    for (const auto &[snapshot, contents] : versions)
+    {
+        ASSERT_TRUE(snapshot.is_balanced());
+        ASSERT_EQ(snapshot.to_vector(), contents);
+    }
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "TreeMap.cpp"
+#include <memory_resource>
 
 // Constructor (TreeMap()) test case
 TEST(TreeMapTest, InstantiateEmptyMap)
@@ -102,4 +103,218 @@ TEST(TreeMapTest, Clear)
     ASSERT_EQ(map.size(), 0);
     ASSERT_FALSE(map.contains(1));
     ASSERT_FALSE(map.contains(2));
-}
\ No newline at end of file
+}
+
+TEST(TreeMapTest, CustomKeyComparator)
+{
+    TreeMap<int, std::string, std::greater<int>> map;
+    map.insert(1, "one");
+    map.insert(3, "three");
+    map.insert(2, "two");
+
+    std::vector<std::pair<int, std::string>> expected = {{3, "three"}, {2, "two"}, {1, "one"}};
+    ASSERT_EQ(map.to_vector(), expected);
+    ASSERT_EQ(map.get(2), std::optional<std::string>("two"));
+}
+
+TEST(TreeMapTest, FindReturnsStoredValue)
+{
+    TreeMap<int, std::vector<int>> map;
+    map.insert(1, {1, 2, 3});
+
+    std::vector<int> *value = map.find(1);
+    ASSERT_NE(value, nullptr);
+    value->push_back(4);
+    ASSERT_EQ(map.get(1), std::optional<std::vector<int>>({1, 2, 3, 4}));
+    ASSERT_EQ(map.find(2), nullptr);
+}
+
+TEST(TreeMapTest, HeterogeneousLookup)
+{
+    TreeMap<std::string, int, std::less<>> map;
+    map.insert("alpha", 1);
+    map.insert("beta", 2);
+
+    std::string_view key = "beta";
+    ASSERT_TRUE(map.contains(key));
+    ASSERT_EQ(map.get(key), std::optional<int>(2));
+    ASSERT_EQ(*map.find(std::string_view("alpha")), 1);
+    ASSERT_FALSE(map.contains(std::string_view("gamma")));
+    ASSERT_TRUE(map.contains("alpha"));
+}
+
+TEST(TreeMapTest, FromSortedRange)
+{
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 1000; i++)
+        items.push_back({i, i * i});
+
+    auto map = TreeMap<int, int>::from_sorted_range(items.begin(), items.end());
+    ASSERT_EQ(map.size(), 1000);
+    ASSERT_EQ(map.get(31), std::optional<int>(961));
+    ASSERT_EQ(map.to_vector(), items);
+}
+
+TEST(TreeMapTest, IterateAndBounds)
+{
+    TreeMap<int, char> map({{3, 'c'}, {1, 'a'}, {2, 'b'}, {5, 'e'}});
+
+    std::string values;
+    for (const auto &entry : map)
+        values += entry.second;
+    ASSERT_EQ(values, "abce");
+
+    ASSERT_EQ(map.rbegin()->first, 5);
+    ASSERT_EQ(map.lower_bound(4)->second, 'e');
+    ASSERT_EQ(map.upper_bound(2)->first, 3);
+    ASSERT_TRUE(map.lower_bound(6) == map.end());
+    ASSERT_EQ(std::distance(map.equal_range(1).first, map.equal_range(1).second), 1);
+}
+
+TEST(TreeMapTest, EraseKeys)
+{
+    TreeMap<int, std::string> map({{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}});
+
+    ASSERT_TRUE(map.erase(2));
+    ASSERT_FALSE(map.erase(2));
+    ASSERT_FALSE(map.contains(2));
+    ASSERT_EQ(map.size(), 3);
+
+    auto next = map.erase(map.lower_bound(3));
+    ASSERT_EQ(next->first, 4);
+    map.erase(map.begin(), map.end());
+    ASSERT_TRUE(map.is_empty());
+}
+
+// Counts copies so tests can check that payloads are moved, not duplicated
+struct CopyCounter
+{
+    static inline int copies = 0;
+    std::string text;
+
+    CopyCounter(std::string text) : text(std::move(text)) {}
+    CopyCounter(const CopyCounter &other) : text(other.text) { copies++; }
+    CopyCounter(CopyCounter &&other) noexcept = default;
+    CopyCounter &operator=(const CopyCounter &other)
+    {
+        text = other.text;
+        copies++;
+        return *this;
+    }
+    CopyCounter &operator=(CopyCounter &&other) noexcept = default;
+};
+
+TEST(TreeMapTest, TryEmplaceAndInsertOrAssign)
+{
+    TreeMap<std::string, CopyCounter> map;
+    CopyCounter::copies = 0;
+
+    auto [first, inserted] = map.try_emplace("a", "alpha");
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(first->second.text, "alpha");
+
+    // A present key leaves the arguments alone
+    CopyCounter spare("unused");
+    auto [second, inserted_again] = map.try_emplace("a", std::move(spare));
+    ASSERT_FALSE(inserted_again);
+    ASSERT_EQ(spare.text, "unused");
+    ASSERT_TRUE(first == second);
+
+    ASSERT_TRUE(map.insert_or_assign("b", CopyCounter("beta")).second);
+    ASSERT_FALSE(map.insert_or_assign("a", CopyCounter("ALPHA")).second);
+    ASSERT_EQ(map.find("a")->text, "ALPHA");
+
+    ASSERT_TRUE(map.emplace("c", CopyCounter("gamma")).second);
+    ASSERT_FALSE(map.emplace("c", CopyCounter("other")).second);
+    map.insert("d", CopyCounter("delta"));
+    map.insert("d", CopyCounter("DELTA"));
+    ASSERT_EQ(map.find("d")->text, "DELTA");
+
+    ASSERT_EQ(map.size(), 4);
+    ASSERT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(TreeMapTest, BatchLookups)
+{
+    TreeMap<int, std::string> map({{1, "a"}, {3, "c"}, {5, "e"}});
+
+    std::vector<std::optional<std::string>> values = map.get_batch({5, 2, 1, 5});
+    std::vector<std::optional<std::string>> expected = {"e", std::nullopt, "a", "e"};
+    ASSERT_EQ(values, expected);
+    ASSERT_EQ(map.contains_batch({0, 3}), std::vector<bool>({false, true}));
+}
+
+TEST(TreeMapTest, RangeQueriesAndPages)
+{
+    TreeMap<int, int> map;
+    for (int i = 0; i < 100; i++)
+        map.insert(i * 10, i);
+
+    auto keys_of = [](const auto &view)
+    {
+        std::vector<int> keys;
+        for (const auto &entry : view)
+            keys.push_back(entry.first);
+        return keys;
+    };
+
+    ASSERT_EQ(keys_of(map.range(25, 60)), std::vector<int>({30, 40, 50}));
+    ASSERT_EQ(keys_of(map.reverse_range(25, 60)), std::vector<int>({50, 40, 30}));
+    ASSERT_TRUE(map.range(60, 25).empty());
+    ASSERT_TRUE(map.range(2000, 3000).empty());
+
+    ASSERT_EQ(map.floor(35)->first, 30);
+    ASSERT_EQ(map.floor(30)->first, 30);
+    ASSERT_TRUE(map.floor(-1) == map.end());
+    ASSERT_EQ(map.ceiling(35)->first, 40);
+    ASSERT_TRUE(map.ceiling(991) == map.end());
+
+    ASSERT_EQ(keys_of(map.first_n_after(30, 3)), std::vector<int>({40, 50, 60}));
+    ASSERT_EQ(map.first_n_after(970, 5).size(), 2);
+    ASSERT_EQ(keys_of(map.last_n_before(30, 5)), std::vector<int>({20, 10, 0}));
+    ASSERT_TRUE(map.last_n_before(0, 5).empty());
+}
+
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(TreeMapTest, MovesTakeTheNodesWithoutAllocating)
+{
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 100000; i++)
+        items.push_back({i, -i});
+    CountingResource resource;
+    auto map = TreeMap<int, int>::from_sorted_range(items.begin(), items.end(), std::less<int>(), &resource);
+    size_t built = resource.allocations;
+
+    TreeMap<int, int> moved(std::move(map));
+    ASSERT_EQ(resource.allocations, built);
+    TreeMap<int, int> target(&resource);
+    target.insert(1, 1);
+    size_t before_assignment = resource.allocations;
+    target = std::move(moved);
+
+    ASSERT_EQ(resource.allocations, before_assignment);
+    ASSERT_TRUE(map.is_empty());
+    ASSERT_TRUE(moved.is_empty());
+    ASSERT_EQ(target.size(), 100000);
+    ASSERT_EQ(target.get(4321), std::optional<int>(-4321));
+}
@@ -1,5 +1,9 @@
 #include "TreeSet.cpp"
 #include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 
 TEST(TreeSetTest, InstantiateEmptyTree)
 {
@@ -25,7 +29,7 @@ TEST(TreeSetTest, InstantiateTreeWithComparator)
             return 0;
         }
     };
-    TreeSet<int> s(cmp);
+    TreeSet<int, ThreeWayComparator<int>> s(cmp);
 
     ASSERT_EQ(s.size(), 0);
 
@@ -136,3 +140,428 @@ TEST(TreeSetTest, IsBalanced)
     TreeSet<int> s({1, 2, 3});
     ASSERT_TRUE(s.is_balanced());
 }
+
+// Memory resource that counts how often the tree asks for storage
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+    size_t live_bytes = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        live_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        live_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(TreeSetTest, NodesComeFromMemoryResourceInSlabs)
+{
+    CountingResource resource;
+    {
+        TreeSet<int> s(&resource);
+        for (int i = 0; i < 10000; i++)
+            s.add(i);
+        s.add(42); // duplicate must not allocate
+
+        ASSERT_EQ(s.size(), 10000);
+        ASSERT_TRUE(s.is_balanced());
+        ASSERT_LT(resource.allocations, 20);
+
+        s.clear();
+        ASSERT_EQ(resource.live_bytes, 0);
+        s.add(7);
+        ASSERT_EQ(s.to_vector(), std::vector<int>({7}));
+    }
+    ASSERT_EQ(resource.live_bytes, 0);
+}
+
+TEST(TreeSetTest, CopyAndMove)
+{
+    TreeSet<std::string> s({"pear", "apple", "fig"});
+    TreeSet<std::string> copy(s);
+    copy.add("kiwi");
+
+    ASSERT_EQ(s.to_vector(), std::vector<std::string>({"apple", "fig", "pear"}));
+    ASSERT_EQ(copy.to_vector(), std::vector<std::string>({"apple", "fig", "kiwi", "pear"}));
+
+    TreeSet<std::string> moved(std::move(copy));
+    ASSERT_EQ(moved.size(), 4);
+    ASSERT_TRUE(copy.is_empty());
+
+    s = moved;
+    ASSERT_EQ(s.size(), 4);
+    ASSERT_TRUE(s.is_balanced());
+}
+
+TEST(TreeSetTest, CompileTimeComparator)
+{
+    static_assert(sizeof(TreeSet<int>) == sizeof(TreeSet<int, std::greater<int>>));
+    static_assert(sizeof(TreeSet<int>) < sizeof(TreeSet<int, ThreeWayComparator<int>>));
+
+    TreeSet<int, std::greater<int>> s({1, 4, 2, 3});
+    ASSERT_EQ(s.to_vector(), std::vector<int>({4, 3, 2, 1}));
+    ASSERT_EQ(s.min(), 4);
+
+    TreeSet<int, std::greater<int>> t({3, 5});
+    ASSERT_EQ((s + t).to_vector(), std::vector<int>({5, 4, 3, 2, 1}));
+    ASSERT_EQ((s & t).to_vector(), std::vector<int>({3}));
+}
+
+TEST(TreeSetTest, MoveIsNoexceptOnlyWhenTheComparatorCopyIs)
+{
+    static_assert(std::is_nothrow_move_constructible_v<TreeSet<int>>);
+    static_assert(std::is_nothrow_move_assignable_v<TreeSet<int>>);
+    static_assert(!std::is_nothrow_move_constructible_v<TreeSet<int, ThreeWayComparator<int>>>);
+    static_assert(!std::is_nothrow_move_assignable_v<TreeSet<int, ThreeWayComparator<int>>>);
+
+    // A moved-from set keeps a working comparator
+    TreeSet<int, ThreeWayComparator<int>> s;
+    s.add(2);
+    TreeSet<int, ThreeWayComparator<int>> moved(std::move(s));
+    s.add(1);
+    s.add(3);
+    ASSERT_EQ(s.to_vector(), std::vector<int>({1, 3}));
+    ASSERT_EQ(moved.to_vector(), std::vector<int>({2}));
+}
+
+// Orders ints ascending; copying it throws while throw_on_copy is set
+struct ThrowingCopyLess
+{
+    static inline bool throw_on_copy = false;
+
+    ThrowingCopyLess() = default;
+    ThrowingCopyLess(const ThrowingCopyLess &)
+    {
+        if (throw_on_copy)
+            throw std::runtime_error("comparator copy failed");
+    }
+    ThrowingCopyLess &operator=(const ThrowingCopyLess &)
+    {
+        if (throw_on_copy)
+            throw std::runtime_error("comparator copy failed");
+        return *this;
+    }
+    bool operator()(int left, int right) const { return left < right; }
+};
+
+TEST(TreeSetTest, AssignmentWithAThrowingComparatorCopyLeavesBothSetsIntact)
+{
+    TreeSet<int, ThrowingCopyLess> target({1, 2, 3});
+    TreeSet<int, ThrowingCopyLess> source({7, 8});
+
+    ThrowingCopyLess::throw_on_copy = true;
+    ASSERT_THROW(target = std::move(source), std::runtime_error);
+    ASSERT_THROW(target = source, std::runtime_error);
+    ThrowingCopyLess::throw_on_copy = false;
+
+    ASSERT_EQ(target.to_vector(), std::vector<int>({1, 2, 3}));
+    ASSERT_EQ(source.to_vector(), std::vector<int>({7, 8}));
+    source.add(9);
+    target = std::move(source);
+    ASSERT_EQ(target.to_vector(), std::vector<int>({7, 8, 9}));
+}
+
+TEST(TreeSetTest, TransparentComparatorLookup)
+{
+    TreeSet<std::string, std::less<>> s({"apple", "banana"});
+    ASSERT_TRUE(s.contains("apple"));
+    ASSERT_FALSE(s.contains("cherry"));
+    ASSERT_EQ(s.get("banana"), std::optional<std::string>("banana"));
+}
+
+TEST(TreeSetTest, FromSortedRangeBuildsValidTree)
+{
+    for (int n = 0; n <= 300; n++)
+    {
+        std::vector<int> items(n);
+        for (int i = 0; i < n; i++)
+            items[i] = i * 2;
+
+        TreeSet<int> s = TreeSet<int>::from_sorted_range(items.begin(), items.end());
+        ASSERT_EQ(s.size(), n);
+        ASSERT_TRUE(s.is_balanced());
+        ASSERT_EQ(s.to_vector(), items);
+
+        s.add(-1);
+        s.add(2 * n + 1);
+        ASSERT_TRUE(s.is_balanced());
+    }
+}
+
+TEST(TreeSetTest, SortedVectorConstructor)
+{
+    TreeSet<int> sorted({1, 2, 3, 4, 5, 6, 7, 8});
+    ASSERT_TRUE(sorted.is_balanced());
+    ASSERT_EQ(sorted.to_vector(), std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8}));
+
+    TreeSet<int> unsorted({3, 1, 2, 3});
+    ASSERT_EQ(unsorted.to_vector(), std::vector<int>({1, 2, 3}));
+
+    std::istringstream input("10 20 30");
+    auto from_stream = TreeSet<int>::from_sorted_range(std::istream_iterator<int>(input), std::istream_iterator<int>());
+    ASSERT_EQ(from_stream.to_vector(), std::vector<int>({10, 20, 30}));
+}
+
+TEST(TreeSetTest, DifferenceAndSymmetricDifference)
+{
+    TreeSet<int> s1({1, 2, 3, 4, 5});
+    TreeSet<int> s2({4, 5, 6, 7});
+
+    ASSERT_EQ((s1 - s2).to_vector(), std::vector<int>({1, 2, 3}));
+    ASSERT_EQ((s2 - s1).to_vector(), std::vector<int>({6, 7}));
+    ASSERT_EQ((s1 ^ s2).to_vector(), std::vector<int>({1, 2, 3, 6, 7}));
+    ASSERT_TRUE((s1 - s1).is_empty());
+    ASSERT_EQ(s1.size(), 5);
+    ASSERT_EQ(s2.size(), 4);
+}
+
+TEST(TreeSetTest, SetAlgebraOnTemporaries)
+{
+    TreeSet<std::string> a({"a", "c", "e"});
+    TreeSet<std::string> b({"b", "c", "d"});
+    TreeSet<std::string> c({"c", "z"});
+
+    TreeSet<std::string> all = a + b + c;
+    ASSERT_EQ(all.to_vector(), std::vector<std::string>({"a", "b", "c", "d", "e", "z"}));
+    ASSERT_TRUE(all.is_balanced());
+
+    ASSERT_EQ((a & (b + c)).to_vector(), std::vector<std::string>({"c"}));
+    ASSERT_EQ(((a + b) - c).to_vector(), std::vector<std::string>({"a", "b", "d", "e"}));
+    ASSERT_EQ(((a + b) ^ (b + c)).to_vector(), std::vector<std::string>({"a", "e", "z"}));
+
+    a += b;
+    ASSERT_EQ(a, TreeSet<std::string>({"a", "b", "c", "d", "e"}));
+    ASSERT_TRUE(a.is_balanced());
+}
+
+TEST(TreeSetTest, SetAlgebraLarge)
+{
+    std::vector<int> evens, threes;
+    for (int i = 0; i < 3000; i += 2)
+        evens.push_back(i);
+    for (int i = 0; i < 3000; i += 3)
+        threes.push_back(i);
+    TreeSet<int> s2(evens), s3(threes);
+
+    TreeSet<int> both = s2 & s3;
+    ASSERT_EQ(both.size(), 500);
+    ASSERT_TRUE(both.is_balanced());
+    ASSERT_EQ((s2 + s3).size(), 2000);
+    ASSERT_EQ((s2 - s3).size(), 1000);
+    ASSERT_EQ((s2 ^ s3).size(), 1500);
+    ASSERT_TRUE((TreeSet<int>(s2) & s3) == both);
+    ASSERT_FALSE(s2 == s3);
+}
+
+TEST(TreeSetTest, IterateInOrder)
+{
+    TreeSet<int> s({5, 1, 4, 2, 3});
+
+    std::vector<int> forward;
+    for (int value : s)
+        forward.push_back(value);
+    ASSERT_EQ(forward, std::vector<int>({1, 2, 3, 4, 5}));
+
+    std::vector<int> backward(s.rbegin(), s.rend());
+    ASSERT_EQ(backward, std::vector<int>({5, 4, 3, 2, 1}));
+
+    auto it = s.end();
+    --it;
+    ASSERT_EQ(*it, 5);
+    ASSERT_EQ(std::distance(s.begin(), s.end()), 5);
+
+    TreeSet<int> empty;
+    ASSERT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(TreeSetTest, Bounds)
+{
+    TreeSet<int> s({10, 20, 30, 40});
+
+    ASSERT_EQ(*s.lower_bound(20), 20);
+    ASSERT_EQ(*s.upper_bound(20), 30);
+    ASSERT_EQ(*s.lower_bound(25), 30);
+    ASSERT_TRUE(s.lower_bound(41) == s.end());
+    ASSERT_EQ(*s.upper_bound(5), 10);
+
+    auto range = s.equal_range(30);
+    ASSERT_EQ(std::distance(range.first, range.second), 1);
+    range = s.equal_range(35);
+    ASSERT_TRUE(range.first == range.second);
+
+    std::vector<int> middle(s.lower_bound(15), s.upper_bound(30));
+    ASSERT_EQ(middle, std::vector<int>({20, 30}));
+}
+
+TEST(TreeSetTest, RemoveElements)
+{
+    TreeSet<int> s({1, 2, 3, 4, 5});
+    ASSERT_TRUE(s.remove(3));
+    ASSERT_FALSE(s.remove(3));
+    ASSERT_EQ(s.size(), 4);
+    ASSERT_EQ(s.to_vector(), std::vector<int>({1, 2, 4, 5}));
+    ASSERT_TRUE(s.is_balanced());
+
+    auto next = s.erase(s.lower_bound(2));
+    ASSERT_EQ(*next, 4);
+    next = s.erase(s.begin(), s.lower_bound(5));
+    ASSERT_EQ(*next, 5);
+    ASSERT_EQ(s.to_vector(), std::vector<int>({5}));
+
+    s.erase(s.begin(), s.end());
+    ASSERT_TRUE(s.is_empty());
+}
+
+TEST(TreeSetTest, RandomChurnStaysBalanced)
+{
+    std::mt19937 rng(36);
+    std::uniform_int_distribution<int> key(0, 500);
+    TreeSet<int> s;
+    std::set<int> reference;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        int k = key(rng);
+        if (rng() % 2)
+        {
+            s.add(k);
+            reference.insert(k);
+        }
+        else
+        {
+            ASSERT_EQ(s.remove(k), reference.erase(k) == 1);
+        }
+        if (i % 500 == 0)
+        {
+            ASSERT_TRUE(s.is_balanced());
+        }
+    }
+
+    ASSERT_EQ(s.size(), reference.size());
+    ASSERT_EQ(s.to_vector(), std::vector<int>(reference.begin(), reference.end()));
+}
+
+TEST(TreeSetTest, OrderStatistics)
+{
+    TreeSet<int, std::less<int>, OrderStatistics> s({10, 20, 30, 40, 50});
+
+    ASSERT_EQ(*s.select(0), 10);
+    ASSERT_EQ(*s.select(3), 40);
+    ASSERT_TRUE(s.select(5) == s.end());
+    ASSERT_EQ(s.rank(10), 0);
+    ASSERT_EQ(s.rank(35), 3);
+    ASSERT_EQ(s.rank(99), 5);
+    ASSERT_EQ(s.count_range(15, 45), 3);
+    ASSERT_EQ(s.count_range(45, 15), 0);
+
+    static_assert(sizeof(BinaryTreeNode<int>) < sizeof(BinaryTreeNode<int, OrderStatistics>));
+}
+
+TEST(TreeSetTest, OrderStatisticsSurviveChurn)
+{
+    std::mt19937 rng(7);
+    TreeSet<int, std::less<int>, OrderStatistics> s;
+    std::set<int> reference;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        int k = rng() % 1000;
+        if (rng() % 3)
+        {
+            s.add(k);
+            reference.insert(k);
+        }
+        else
+        {
+            s.remove(k);
+            reference.erase(k);
+        }
+    }
+    std::vector<int> before(reference.begin(), reference.end());
+    for (size_t k = 0; k < before.size(); k++)
+        ASSERT_EQ(*s.select(k), before[k]);
+
+    auto merged = s + TreeSet<int, std::less<int>, OrderStatistics>({-5, 2000});
+    reference.insert(-5);
+    reference.insert(2000);
+
+    std::vector<int> expected(reference.begin(), reference.end());
+    for (size_t k = 0; k < expected.size(); k++)
+    {
+        ASSERT_EQ(*merged.select(k), expected[k]);
+        ASSERT_EQ(merged.rank(expected[k]), k);
+    }
+}
+
+TEST(TreeSetTest, InsertAndEmplaceReportWhetherAdded)
+{
+    TreeSet<std::string> set;
+
+    auto [it, inserted] = set.insert(std::string("pear"));
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(*it, "pear");
+    ASSERT_FALSE(set.insert("pear").second);
+
+    auto [emplaced, added] = set.emplace(3, 'x');
+    ASSERT_TRUE(added);
+    ASSERT_EQ(*emplaced, "xxx");
+    ASSERT_FALSE(set.emplace("xxx").second);
+
+    std::string moved = "apple";
+    set.insert(std::move(moved));
+    ASSERT_EQ(set.to_vector(), std::vector<std::string>({"apple", "pear", "xxx"}));
+    ASSERT_TRUE(set.is_balanced());
+}
+
+TEST(TreeSetTest, CopyAndClearLargeTreeWithoutRecursion)
+{
+    std::vector<std::string> items;
+    for (int i = 0; i < 20000; i++)
+        items.push_back(std::to_string(i));
+    TreeSet<std::string> set(items);
+
+    TreeSet<std::string> copy(set);
+    ASSERT_TRUE(copy.is_balanced());
+    ASSERT_EQ(copy.to_vector(), set.to_vector());
+
+    copy.clear();
+    ASSERT_TRUE(copy.is_empty());
+    ASSERT_TRUE(copy.to_vector().empty());
+    copy.add("again");
+    ASSERT_EQ(copy.size(), 1);
+}
+
+TEST(TreeSetTest, BatchLookupsMatchSingleLookups)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 1000; i++)
+        values.push_back(i * 2);
+    TreeSet<int> set(values);
+
+    std::vector<int> probes;
+    for (int i = -5; i < 2010; i += 3)
+        probes.push_back(i);
+
+    std::vector<bool> contained = set.contains_batch(probes);
+    std::vector<std::optional<int>> found = set.get_batch(probes);
+    ASSERT_EQ(contained.size(), probes.size());
+    for (size_t i = 0; i < probes.size(); i++)
+    {
+        ASSERT_EQ(contained[i], set.contains(probes[i]));
+        ASSERT_EQ(found[i], set.get(probes[i]));
+    }
+    ASSERT_TRUE(TreeSet<int>().contains_batch({1, 2}) == std::vector<bool>({false, false}));
+    ASSERT_TRUE(set.contains_batch({}).empty());
+}
@@ -0,0 +1,66 @@
+// external_sort on files several times its memory budget: random 64-bit
+// keys, and text log lines with a timestamp up front. Reports throughput
+// and how many runs and merge passes each budget took. The sort reads and
+// writes real files in the temp directory, so a warm page cache flatters
+// the I/O; the first row of a fresh file is the honest one.
+//
+//   g++ -std=c++17 -O2 -pthread -I hw3/lib hw3/bench/ExternalSortBench.cpp -o external_sort_bench
+#include "ExternalSort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename T>
+void run(const char *name, WorkStealingPool &pool, const std::string &input, size_t budget)
+{
+    std::string output = input + ".sorted";
+    ExternalSortOptions options;
+    options.memory_budget = budget;
+    auto start = std::chrono::steady_clock::now();
+    ExternalSortStats stats = external_sort<T>(pool, input, output, std::less<T>(), options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double megabytes = std::filesystem::file_size(input) / 1e6;
+    std::printf("%-8s %10.0f %10zu %10.1f %8zu %8zu %10.1f\n", name, megabytes, budget >> 20, seconds, stats.runs,
+                stats.merge_passes, megabytes / seconds);
+    std::filesystem::remove(output);
+}
+
+int main(int argc, char **argv)
+{
+    size_t records = size_t(1) << 25;
+    if (argc > 1)
+        records = std::stoul(argv[1]);
+    std::string directory = std::filesystem::temp_directory_path().string();
+    WorkStealingPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::mt19937_64 rng(36);
+    std::string keys = directory + "/external_sort_bench.keys";
+    {
+        RecordWriter<uint64_t> writer(keys, 1 << 20);
+        for (size_t i = 0; i < records; i++)
+            writer.write(rng());
+        writer.close();
+    }
+    std::string lines = directory + "/external_sort_bench.log";
+    {
+        RecordWriter<std::string> writer(lines, 1 << 20);
+        for (size_t i = 0; i < records / 4; i++)
+            writer.write(std::to_string(1'767'225'600'000'000ULL + rng() % 86'400'000'000ULL) + " GET /api/item/" +
+                         std::to_string(rng() % 100000) + " 200");
+        writer.close();
+    }
+
+    std::printf("%-8s %10s %10s %10s %8s %8s %10s\n", "input", "MB", "budget MB", "seconds", "runs", "passes", "MB/s");
+    for (size_t budget : {size_t(256) << 20, size_t(64) << 20, size_t(16) << 20})
+    {
+        run<uint64_t>("uint64", pool, keys, budget);
+        run<std::string>("lines", pool, lines, budget);
+    }
+    std::filesystem::remove(keys);
+    std::filesystem::remove(lines);
+    return 0;
+}
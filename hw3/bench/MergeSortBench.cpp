@@ -0,0 +1,117 @@
+// merge_sort against std::stable_sort and quick_sort on log-shaped input:
+// random records, already sorted, nearly sorted (a few late arrivals),
+// reversed, and several sorted logs concatenated. Then merge_sort with a
+// bounded buffer, and the parallel merge_sort from 1 thread up to the
+// number of hardware threads. Keys are (timestamp, sequence) records
+// compared by timestamp only. Each time is the best of several rounds, in
+// nanoseconds per record.
+//
+//   g++ -std=c++17 -O2 -pthread -I hw3/lib hw3/bench/MergeSortBench.cpp -o merge_sort_bench
+#include "MergeSort.cpp"
+#include "qsort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Record
+{
+    uint64_t timestamp;
+    uint64_t sequence;
+};
+
+static bool by_timestamp(const Record &a, const Record &b)
+{
+    return a.timestamp < b.timestamp;
+}
+
+// Rounds are repeated until about this many records have been sorted
+const size_t RECORDS_PER_MEASUREMENT = 8'000'000;
+
+template <typename Sort>
+double ns_per_record(const std::vector<Record> &input, Sort sort)
+{
+    size_t rounds = std::max<size_t>(3, RECORDS_PER_MEASUREMENT / input.size());
+    double best = 1e30;
+    for (size_t round = 0; round < rounds; round++)
+    {
+        std::vector<Record> v = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(v);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best / input.size();
+}
+
+static std::vector<Record> make_records(const char *shape, size_t n)
+{
+    std::mt19937_64 rng(36);
+    std::vector<Record> records(n);
+    std::string kind = shape;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t t = 1'767'225'600'000'000ULL + i * 1000;
+        if (kind == "random")
+            t = rng() % (n * 1000);
+        else if (kind == "reversed")
+            t = (n - i) * 1000;
+        else if (kind == "8 logs")
+            t = (i % (n / 8)) * 1000 + rng() % 1000;
+        records[i] = {t, i};
+    }
+    if (kind == "nearly")
+    {
+        // One record in a hundred arrives up to a second late
+        for (size_t i = 0; i < n; i += 100)
+            records[i].timestamp -= std::min<uint64_t>(records[i].timestamp, rng() % 1'000'000);
+    }
+    return records;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = 1 << 20;
+    if (argc > 1)
+        n = std::stoul(argv[1]);
+    seed_quick_sort(36);
+    const char *shapes[] = {"random", "sorted", "nearly", "reversed", "8 logs"};
+
+    std::printf("ns per record, n = %zu, best of several rounds\n", n);
+    std::printf("%-10s %12s %12s %12s %12s %12s\n", "input", "merge_sort", "stable_sort", "quick_sort", "buffer 1/64",
+                "in place");
+    for (const char *shape : shapes)
+    {
+        std::vector<Record> input = make_records(shape, n);
+        double ours = ns_per_record(input, [](std::vector<Record> &v)
+                                    { merge_sort(v.begin(), v.end(), by_timestamp); });
+        double stable = ns_per_record(input, [](std::vector<Record> &v)
+                                      { std::stable_sort(v.begin(), v.end(), by_timestamp); });
+        double quick = ns_per_record(input, [](std::vector<Record> &v)
+                                     { quick_sort(v.begin(), v.end(), by_timestamp); });
+        double bounded = ns_per_record(input, [](std::vector<Record> &v)
+                                       { merge_sort(v.begin(), v.end(), by_timestamp, v.size() / 64); });
+        double in_place = ns_per_record(input, [](std::vector<Record> &v)
+                                        { merge_sort(v.begin(), v.end(), by_timestamp, 0); });
+        std::printf("%-10s %12.1f %12.1f %12.1f %12.1f %12.1f\n", shape, ours, stable, quick, bounded, in_place);
+    }
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Record> input = make_records("random", n);
+    std::printf("\nparallel merge_sort on random records\n");
+    std::printf("%-8s %12s %12s\n", "threads", "merge_sort", "speedup");
+    double sequential = ns_per_record(input, [](std::vector<Record> &v)
+                                      { merge_sort(v.begin(), v.end(), by_timestamp); });
+    // Doubling thread counts, ending on the hardware thread count
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        WorkStealingPool pool(threads);
+        double ours = ns_per_record(input, [&pool](std::vector<Record> &v)
+                                    { merge_sort(pool, v.begin(), v.end(), by_timestamp); });
+        std::printf("%-8u %12.1f %11.2fx\n", threads, ours, sequential / ours);
+        if (threads == max_threads)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Parallel quick_sort on a work-stealing pool against
+// std::sort(std::execution::par, ...), from 1 thread up to the number of
+// hardware threads. libstdc++ runs the parallel algorithms on TBB, which is
+// limited to the same thread count through tbb::global_control.
+//
+//   g++ -std=c++17 -O2 -pthread -I hw3/lib hw3/bench/ParallelSortBench.cpp -ltbb -o parallel_sort_bench
+#include "qsort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <execution>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tbb/global_control.h>
+
+template <typename Sort>
+double time_ms(const std::vector<int> &input, Sort sort)
+{
+    double best = 1e30;
+    for (int round = 0; round < 3; round++)
+    {
+        std::vector<int> v = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(v);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 16'000'000;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<int> random(n);
+    std::vector<int> few_unique(n);
+    std::mt19937 rng(36);
+    for (size_t i = 0; i < n; i++)
+    {
+        random[i] = static_cast<int>(rng());
+        few_unique[i] = static_cast<int>(rng() % 16);
+    }
+
+    double sequential = time_ms(random, [](std::vector<int> &v)
+                                { quick_sort(v.begin(), v.end(), std::less<int>()); });
+    std::printf("%zu random ints, best of 3 (ms); sequential quick_sort %.1f\n", n, sequential);
+    std::printf("%-8s %12s %12s %12s %14s\n", "threads", "quick_sort", "speedup", "std par", "few-unique qs");
+
+    // Doubling thread counts, ending on the hardware thread count
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        WorkStealingPool pool(threads);
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, threads);
+
+        double ours = time_ms(random, [&pool](std::vector<int> &v)
+                              { quick_sort(pool, v.begin(), v.end(), std::less<int>()); });
+        double theirs = time_ms(random, [](std::vector<int> &v)
+                                { std::sort(std::execution::par, v.begin(), v.end(), std::less<int>()); });
+        double few = time_ms(few_unique, [&pool](std::vector<int> &v)
+                             { quick_sort(pool, v.begin(), v.end(), std::less<int>()); });
+        std::printf("%-8u %12.1f %11.2fx %12.1f %14.1f\n", threads, ours, sequential / ours, theirs, few);
+
+        if (threads == max_threads)
+            break;
+    }
+    return 0;
+}
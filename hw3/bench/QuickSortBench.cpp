@@ -0,0 +1,69 @@
+// quick_sort, with each partition scheme, against std::sort on the input patterns that defeat naive
+// quicksorts.
+//
+//   g++ -std=c++17 -O2 -I hw3/lib hw3/bench/QuickSortBench.cpp -o quick_sort_bench
+#include "qsort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+std::vector<int> make_pattern(const std::string &name, size_t n)
+{
+    std::vector<int> v(n);
+    std::mt19937 rng(36);
+    for (size_t i = 0; i < n; i++)
+    {
+        int k = static_cast<int>(i);
+        if (name == "random")
+            v[i] = static_cast<int>(rng());
+        else if (name == "sorted")
+            v[i] = k;
+        else if (name == "reversed")
+            v[i] = static_cast<int>(n) - k;
+        else if (name == "organ-pipe")
+            v[i] = i < n / 2 ? k : static_cast<int>(n) - k;
+        else if (name == "all-equal")
+            v[i] = 42;
+        else // few-unique
+            v[i] = static_cast<int>(rng() % 16);
+    }
+    return v;
+}
+
+template <typename Sort>
+double time_ms(const std::vector<int> &input, Sort sort)
+{
+    double best = 1e30;
+    for (int round = 0; round < 3; round++)
+    {
+        std::vector<int> v = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(v);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    seed_quick_sort(36);
+
+    std::printf("%zu ints, best of 3 (ms)\n", n);
+    std::printf("%-12s %12s %12s %12s\n", "pattern", "Hoare", "ThreeWay", "std::sort");
+    for (const char *name : {"random", "sorted", "reversed", "organ-pipe", "all-equal", "few-unique"})
+    {
+        std::vector<int> input = make_pattern(name, n);
+        double hoare = time_ms(input, [](std::vector<int> &v)
+                               { quick_sort(v.begin(), v.end(), std::less<int>(), PartitionScheme::Hoare); });
+        double three_way = time_ms(input, [](std::vector<int> &v)
+                                   { quick_sort(v.begin(), v.end(), std::less<int>(), PartitionScheme::ThreeWay); });
+        double theirs = time_ms(input, [](std::vector<int> &v)
+                                { std::sort(v.begin(), v.end(), std::less<int>()); });
+        std::printf("%-12s %12.1f %12.1f %12.1f\n", name, hoare, three_way, theirs);
+    }
+    return 0;
+}
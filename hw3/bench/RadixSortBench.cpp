@@ -0,0 +1,84 @@
+// radix_sort against quick_sort, dispatch_sort and std::sort on the keys we
+// sort most: random ints of several widths, timestamps (wide keys with a
+// narrow spread), doubles and short strings, from small to large ranges. Each time is the
+// best of several rounds, in nanoseconds per key.
+//
+//   g++ -std=c++17 -O2 -I hw3/lib hw3/bench/RadixSortBench.cpp -o radix_sort_bench
+#include "RadixSort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rounds are repeated until about this many keys have been sorted
+const size_t KEYS_PER_MEASUREMENT = 8'000'000;
+
+template <typename T, typename Sort>
+double ns_per_key(const std::vector<T> &input, Sort sort)
+{
+    size_t rounds = std::max<size_t>(3, KEYS_PER_MEASUREMENT / input.size());
+    double best = 1e30;
+    for (size_t round = 0; round < rounds; round++)
+    {
+        std::vector<T> v = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(v);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best / input.size();
+}
+
+template <typename T>
+void run(const char *name, const std::vector<T> &input)
+{
+    double radix = ns_per_key(input, [](std::vector<T> &v)
+                              { radix_sort(v.begin(), v.end()); });
+    double quick = ns_per_key(input, [](std::vector<T> &v)
+                              { quick_sort(v.begin(), v.end(), std::less<T>()); });
+    double dispatch = ns_per_key(input, [](std::vector<T> &v)
+                                 { dispatch_sort(v.begin(), v.end(), std::less<T>()); });
+    double theirs = ns_per_key(input, [](std::vector<T> &v)
+                               { std::sort(v.begin(), v.end()); });
+    std::printf("%-10s %9zu %9.1f %9.1f %9.1f %9.1f\n", name, input.size(), radix, quick, dispatch, theirs);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> sizes{256, 1024, 4096, 65536, 1 << 20};
+    if (argc > 1)
+        sizes = {std::stoul(argv[1])};
+    seed_quick_sort(36);
+
+    std::printf("ns per key, best of several rounds\n");
+    std::printf("%-10s %9s %9s %9s %9s %9s\n", "keys", "n", "radix", "quick", "dispatch", "std::sort");
+    for (size_t n : sizes)
+    {
+        std::mt19937_64 rng(36);
+        std::vector<int32_t> ints(n);
+        std::vector<int64_t> longs(n);
+        std::vector<int16_t> shorts(n);
+        std::vector<uint64_t> timestamps(n);
+        std::vector<double> doubles(n);
+        std::vector<std::string> strings(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            ints[i] = static_cast<int32_t>(rng());
+            longs[i] = static_cast<int64_t>(rng());
+            shorts[i] = static_cast<int16_t>(rng());
+            // Microseconds within one day of 2026
+            timestamps[i] = 1'767'225'600'000'000ULL + rng() % 86'400'000'000ULL;
+            doubles[i] = static_cast<double>(static_cast<int64_t>(rng())) / 1e9;
+            strings[i] = "user" + std::to_string(rng() % 10'000'000);
+        }
+
+        run("int32", ints);
+        run("int64", longs);
+        run("int16", shorts);
+        run("timestamp", timestamps);
+        run("double", doubles);
+        run("string", strings);
+    }
+    return 0;
+}
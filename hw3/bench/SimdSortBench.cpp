@@ -0,0 +1,62 @@
+// quick_sort on arithmetic keys: the vectorized kernels (std::less) against
+// the generic introsort (the same order through a lambda, which the kernels
+// do not take) and std::sort, for every supported key type.
+//
+//   g++ -std=c++17 -O2 -I hw3/lib hw3/bench/SimdSortBench.cpp -o simd_sort_bench
+#include "qsort.cpp"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+template <typename T, typename Sort>
+double time_ms(const std::vector<T> &input, Sort sort)
+{
+    double best = 1e30;
+    for (int round = 0; round < 3; round++)
+    {
+        std::vector<T> v = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(v);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+template <typename T>
+void run(const char *name, size_t n, uint64_t distinct)
+{
+    std::mt19937_64 rng(36);
+    std::vector<T> input(n);
+    for (T &key : input)
+        key = static_cast<T>(rng() % distinct);
+
+    double simd = time_ms(input, [](std::vector<T> &v)
+                          { quick_sort(v.begin(), v.end(), std::less<T>()); });
+    double generic = time_ms(input, [](std::vector<T> &v)
+                             { quick_sort(v.begin(), v.end(), [](T a, T b)
+                                          { return a < b; }); });
+    double theirs = time_ms(input, [](std::vector<T> &v)
+                            { std::sort(v.begin(), v.end()); });
+    std::printf("%-10s %10llu %10.1f %10.1f %10.1f %9.2fx\n", name, static_cast<unsigned long long>(distinct), simd,
+                generic, theirs, generic / simd);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    seed_quick_sort(36);
+
+    std::printf("%zu keys, best of 3 (ms)\n", n);
+    std::printf("%-10s %10s %10s %10s %10s %10s\n", "type", "distinct", "simd", "generic", "std::sort", "speedup");
+    for (uint64_t distinct : {uint64_t(1) << 62, uint64_t(100)})
+    {
+        run<int32_t>("int32", n, std::min<uint64_t>(distinct, 1ULL << 31));
+        run<float>("float", n, std::min<uint64_t>(distinct, 1ULL << 24));
+        run<double>("double", n, std::min<uint64_t>(distinct, 1ULL << 53));
+        run<uint64_t>("uint64", n, distinct);
+    }
+    return 0;
+}
@@ -0,0 +1,415 @@
+#ifndef EXTERNAL_SORT_CPP
+#define EXTERNAL_SORT_CPP
+
+#include "ExternalSort.hpp"
+#include "MergeSort.cpp"
+#include "RadixSort.cpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+template <typename T>
+RecordReader<T>::RecordReader(const std::string &path, size_t buffer_bytes)
+    : _in(path, std::ios::binary), _path(path), _buffer(std::max(buffer_bytes, sizeof(T))), _position(0), _end(0)
+{
+    if (!_in)
+        throw std::runtime_error("cannot open record file " + path);
+}
+
+// refill() - Moves the unread bytes to the front of the buffer and reads
+// after them; returns false if the file had nothing more
+template <typename T>
+bool RecordReader<T>::refill()
+{
+    std::copy(_buffer.begin() + _position, _buffer.begin() + _end, _buffer.begin());
+    _end -= _position;
+    _position = 0;
+
+    _in.read(_buffer.data() + _end, _buffer.size() - _end);
+    if (_in.bad())
+        throw std::runtime_error("cannot read record file " + _path);
+    size_t read = static_cast<size_t>(_in.gcount());
+    _end += read;
+    return read > 0;
+}
+
+template <typename T>
+bool RecordReader<T>::next(T &record)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        // A last line without a newline is still a record
+        record.clear();
+        bool partial = false;
+        while (true)
+        {
+            if (_position == _end && !refill())
+                return partial;
+            const char *begin = _buffer.data() + _position;
+            const char *newline = static_cast<const char *>(std::memchr(begin, '\n', _end - _position));
+            if (newline != nullptr)
+            {
+                record.append(begin, newline);
+                _position += newline - begin + 1;
+                return true;
+            }
+            record.append(begin, _end - _position);
+            _position = _end;
+            partial = true;
+        }
+    }
+    else
+    {
+        while (_end - _position < sizeof(T))
+        {
+            if (!refill())
+            {
+                if (_end != _position)
+                    throw std::runtime_error("record file " + _path + " ends inside a record");
+                return false;
+            }
+        }
+        std::memcpy(&record, _buffer.data() + _position, sizeof(T));
+        _position += sizeof(T);
+        return true;
+    }
+}
+
+template <typename T>
+RecordWriter<T>::RecordWriter(const std::string &path, size_t buffer_bytes)
+    : _out(path, std::ios::binary | std::ios::trunc), _path(path), _buffer(std::max<size_t>(buffer_bytes, 1)), _used(0)
+{
+    if (!_out)
+        throw std::runtime_error("cannot create record file " + path);
+}
+
+// put() - Appends bytes to the buffer, writing it out each time it fills
+template <typename T>
+void RecordWriter<T>::put(const char *bytes, size_t length)
+{
+    while (length > 0)
+    {
+        if (_used == _buffer.size())
+            flush();
+        size_t count = std::min(length, _buffer.size() - _used);
+        std::memcpy(_buffer.data() + _used, bytes, count);
+        _used += count;
+        bytes += count;
+        length -= count;
+    }
+}
+
+template <typename T>
+void RecordWriter<T>::flush()
+{
+    _out.write(_buffer.data(), _used);
+    if (!_out)
+        throw std::runtime_error("cannot write record file " + _path);
+    _used = 0;
+}
+
+template <typename T>
+void RecordWriter<T>::write(const T &record)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        put(record.data(), record.size());
+        put("\n", 1);
+    }
+    else
+    {
+        put(reinterpret_cast<const char *>(&record), sizeof(T));
+    }
+}
+
+// close() - Writes out the buffer and closes the file
+template <typename T>
+void RecordWriter<T>::close()
+{
+    flush();
+    _out.close();
+    if (!_out)
+        throw std::runtime_error("cannot write record file " + _path);
+}
+
+// The tree is stored as an array: inner nodes 1..k-1, and source i as the
+// leaf k + i, so the parent of node n is n / 2 for any k
+template <typename T, typename Comparator>
+LoserTree<T, Comparator>::LoserTree(const std::vector<const T *> &heads, Comparator comparator)
+    : _heads(heads), _losers(std::max<size_t>(heads.size(), 1)), _winner(0), _comparator(comparator)
+{
+    size_t k = _heads.size();
+    if (k == 0)
+        return;
+
+    // Plays every match once, bottom up, keeping the winners on the side
+    std::vector<size_t> winners(2 * k);
+    for (size_t i = 0; i < k; i++)
+        winners[k + i] = i;
+    for (size_t node = k - 1; node >= 1; node--)
+    {
+        size_t a = winners[2 * node];
+        size_t b = winners[2 * node + 1];
+        bool a_wins = beats(a, b);
+        winners[node] = a_wins ? a : b;
+        _losers[node] = a_wins ? b : a;
+    }
+    _winner = winners[1];
+}
+
+// beats() - Whether source a's head goes before source b's; exhausted sources lose to all others
+template <typename T, typename Comparator>
+bool LoserTree<T, Comparator>::beats(size_t a, size_t b) const
+{
+    const T *x = _heads[a];
+    const T *y = _heads[b];
+    if (x == nullptr || y == nullptr)
+        return y == nullptr && (x != nullptr || a < b);
+    if (_comparator(*y, *x))
+        return false;
+    return a < b || _comparator(*x, *y);
+}
+
+template <typename T, typename Comparator>
+size_t LoserTree<T, Comparator>::winner() const
+{
+    return _winner;
+}
+
+template <typename T, typename Comparator>
+bool LoserTree<T, Comparator>::exhausted() const
+{
+    return _heads.empty() || _heads[_winner] == nullptr;
+}
+
+template <typename T, typename Comparator>
+void LoserTree<T, Comparator>::replace_winner(const T *head)
+{
+    _heads[_winner] = head;
+    size_t contender = _winner;
+    for (size_t node = (_heads.size() + contender) / 2; node >= 1; node /= 2)
+    {
+        if (beats(_losers[node], contender))
+            std::swap(_losers[node], contender);
+    }
+    _winner = contender;
+}
+
+// Temporary file holding one sorted run, removed when it is dropped
+struct RunFile
+{
+    std::string path;
+
+    explicit RunFile(const std::string &directory)
+    {
+        static std::atomic<uint64_t> counter{0};
+        static const uint64_t session = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+        std::string name = "external_sort." + std::to_string(session) + "." + std::to_string(counter++) + ".run";
+        path = (std::filesystem::path(directory) / name).string();
+    }
+    RunFile(const RunFile &) = delete;
+    RunFile &operator=(const RunFile &) = delete;
+    ~RunFile()
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+};
+
+// chunk_has_room() - Whether another record may join the chunk. Each slot
+// of the chunk's capacity costs its record and the record's slot in the
+// merge_sort buffer, and lines also cost their characters. Fixed-size
+// chunks are reserved up front and never grow; a chunk of lines only
+// doubles its capacity while the doubled slots still fit the budget.
+template <typename T>
+bool chunk_has_room(std::vector<T> &chunk, size_t characters, size_t chunk_budget)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (chunk.size() == chunk.capacity())
+        {
+            size_t grown = std::max<size_t>(16, 2 * chunk.capacity());
+            if (!chunk.empty() && characters + 2 * sizeof(std::string) * grown > chunk_budget)
+                return false;
+            chunk.reserve(grown);
+        }
+        return chunk.empty() || characters + 2 * sizeof(std::string) * chunk.capacity() < chunk_budget;
+    }
+    else
+    {
+        return chunk.size() < chunk.capacity();
+    }
+}
+
+// sort_chunk() - Sorts a chunk on pool. Integer and string records ordered
+// by std::less or std::greater only compare equal when identical, so
+// stability is moot and they take the unstable kernels: the parallel
+// quick_sort, or dispatch_sort() on a single worker. Everything else takes
+// the stable parallel merge_sort.
+template <typename T, typename Comparator>
+void sort_chunk(WorkStealingPool &pool, std::vector<T> &chunk, Comparator &comparator)
+{
+    using Radix = RadixSortable<typename std::vector<T>::iterator, Comparator>;
+    if constexpr (Radix::value && !std::is_floating_point_v<T>)
+    {
+        if (pool.size() > 1)
+            quick_sort(pool, chunk.begin(), chunk.end(), comparator);
+        else
+            dispatch_sort(chunk.begin(), chunk.end(), comparator);
+    }
+    else
+    {
+        merge_sort(pool, chunk.begin(), chunk.end(), comparator);
+    }
+}
+
+// write_run() - Writes sorted records to path
+template <typename T>
+void write_run(const std::vector<T> &records, const std::string &path, size_t buffer_bytes)
+{
+    RecordWriter<T> writer(path, buffer_bytes);
+    for (const T &record : records)
+        writer.write(record);
+    writer.close();
+}
+
+// merge_run_files() - Merges the sorted runs in the files at inputs, in
+// order, into the file at output, with a buffer of buffer_bytes for each
+template <typename T, typename Comparator>
+void merge_run_files(const std::vector<std::string> &inputs, const std::string &output, size_t buffer_bytes,
+                     Comparator &comparator)
+{
+    std::vector<RecordReader<T>> readers;
+    readers.reserve(inputs.size());
+    std::vector<T> heads(inputs.size());
+    std::vector<const T *> head_pointers(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        readers.emplace_back(inputs[i], buffer_bytes);
+        head_pointers[i] = readers[i].next(heads[i]) ? &heads[i] : nullptr;
+    }
+
+    RecordWriter<T> writer(output, buffer_bytes);
+    LoserTree<T, Comparator &> tree(head_pointers, comparator);
+    while (!tree.exhausted())
+    {
+        size_t source = tree.winner();
+        writer.write(heads[source]);
+        tree.replace_winner(readers[source].next(heads[source]) ? &heads[source] : nullptr);
+    }
+    writer.close();
+}
+
+template <typename T, typename Comparator>
+ExternalSortStats external_sort(WorkStealingPool &pool, const std::string &input_path, const std::string &output_path,
+                                Comparator comparator, const ExternalSortOptions &options)
+{
+    static_assert(is_external_record_v<T>, "records are trivially copyable or std::string lines");
+    ExternalSortStats stats;
+    std::string directory = options.temp_directory;
+    if (directory.empty())
+        directory = std::filesystem::temp_directory_path().string();
+
+    // While runs are formed, the input and the run being written each have
+    // an I/O buffer; the rest of the budget holds the chunk
+    size_t io_bytes = std::max<size_t>(1, std::min(options.io_buffer_bytes, options.memory_budget / 8));
+    size_t chunk_budget = std::max<size_t>(1, options.memory_budget - 2 * io_bytes);
+
+    std::vector<std::unique_ptr<RunFile>> runs;
+    std::vector<T> chunk;
+    {
+        RecordReader<T> reader(input_path, io_bytes);
+        if constexpr (!std::is_same_v<T, std::string>)
+        {
+            // Sized once, so push_back never reallocates past the budget;
+            // a smaller input only gets the slots it needs
+            size_t slots = std::max<size_t>(1, chunk_budget / (2 * sizeof(T)));
+            std::error_code error;
+            uintmax_t input_bytes = std::filesystem::file_size(input_path, error);
+            if (!error)
+                slots = static_cast<size_t>(std::min<uintmax_t>(slots, input_bytes / sizeof(T) + 1));
+            chunk.reserve(slots);
+        }
+
+        bool more = true;
+        while (more)
+        {
+            chunk.clear();
+            size_t characters = 0;
+            T record{};
+            while (chunk_has_room(chunk, characters, chunk_budget) && (more = reader.next(record)))
+            {
+                if constexpr (std::is_same_v<T, std::string>)
+                    characters += record.size();
+                chunk.push_back(std::move(record));
+            }
+            if (chunk.empty())
+                break;
+
+            sort_chunk(pool, chunk, comparator);
+            stats.records += chunk.size();
+            stats.runs++;
+            // Input that fits in one chunk goes straight to the output once the reader is closed
+            if (runs.empty() && !more)
+                break;
+            runs.push_back(std::make_unique<RunFile>(directory));
+            write_run(chunk, runs.back()->path, io_bytes);
+            chunk.clear();
+        }
+    }
+
+    if (runs.empty())
+    {
+        write_run(chunk, output_path, io_bytes);
+        return stats;
+    }
+    std::vector<T>().swap(chunk);
+
+    // Each run being merged and the output get an I/O buffer; when the
+    // budget cannot hold one for every run, earlier passes merge groups of
+    // neighbouring runs so that the order of equal records is kept
+    size_t fan_in = std::max<size_t>(2, options.memory_budget / io_bytes - 1);
+    while (true)
+    {
+        bool last_pass = runs.size() <= fan_in;
+        std::vector<std::unique_ptr<RunFile>> merged;
+        for (size_t begin = 0; begin < runs.size(); begin += fan_in)
+        {
+            size_t end = std::min(begin + fan_in, runs.size());
+            if (end - begin == 1 && !last_pass)
+            {
+                merged.push_back(std::move(runs[begin]));
+                continue;
+            }
+
+            std::vector<std::string> inputs;
+            for (size_t i = begin; i < end; i++)
+                inputs.push_back(runs[i]->path);
+            size_t buffer_bytes = std::max<size_t>(1, std::min(io_bytes, options.memory_budget / (inputs.size() + 1)));
+            if (last_pass)
+            {
+                merge_run_files<T>(inputs, output_path, buffer_bytes, comparator);
+            }
+            else
+            {
+                merged.push_back(std::make_unique<RunFile>(directory));
+                merge_run_files<T>(inputs, merged.back()->path, buffer_bytes, comparator);
+            }
+            for (size_t i = begin; i < end; i++)
+                runs[i].reset();
+        }
+        stats.merge_passes++;
+        if (last_pass)
+            return stats;
+        runs = std::move(merged);
+    }
+}
+
+#endif
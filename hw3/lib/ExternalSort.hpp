@@ -0,0 +1,129 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Records an external sort can read and write: trivially copyable values
+// stored as raw fixed-size records, or std::string for text with one
+// newline-terminated record per line
+template <typename T>
+inline constexpr bool is_external_record_v = std::is_trivially_copyable_v<T> || std::is_same_v<T, std::string>;
+
+struct ExternalSortOptions
+{
+    // Bytes of records and I/O buffers held in memory at once
+    size_t memory_budget = size_t(256) << 20;
+    // Bytes read or written per system call; the merge gives each run
+    // this much, or less when the budget cannot hold that many buffers
+    size_t io_buffer_bytes = size_t(1) << 20;
+    // Where sorted runs are spilled; empty means the system temp directory
+    std::string temp_directory;
+};
+
+struct ExternalSortStats
+{
+    size_t records = 0;
+    // Sorted runs written by the first pass
+    size_t runs = 0;
+    // Merge passes over the data; 0 when the input fit in one run
+    size_t merge_passes = 0;
+};
+
+// Buffered sequential reader of records from a file. next() throws
+// std::runtime_error if the file ends inside a fixed-size record.
+template <typename T>
+class RecordReader
+{
+    static_assert(is_external_record_v<T>, "records are trivially copyable or std::string lines");
+
+private:
+    std::ifstream _in;
+    std::string _path;
+    std::vector<char> _buffer;
+    size_t _position;
+    size_t _end;
+
+    bool refill();
+
+public:
+    // Opens path; throws std::runtime_error if it cannot be read
+    RecordReader(const std::string &path, size_t buffer_bytes);
+
+    // next() - Reads the next record into record; returns false at the end of the file
+    bool next(T &record);
+};
+
+// Buffered sequential writer of records to a file. Write failures throw
+// std::runtime_error; the file is only complete once close() returns.
+template <typename T>
+class RecordWriter
+{
+    static_assert(is_external_record_v<T>, "records are trivially copyable or std::string lines");
+
+private:
+    std::ofstream _out;
+    std::string _path;
+    std::vector<char> _buffer;
+    size_t _used;
+
+    void put(const char *bytes, size_t length);
+    void flush();
+
+public:
+    // Creates or truncates path; throws std::runtime_error if it cannot be written
+    RecordWriter(const std::string &path, size_t buffer_bytes);
+
+    void write(const T &record);
+    void close();
+};
+
+// Tournament tree of losers for k-way merging. Each inner node holds the
+// source that lost the match played there and the root's winner is the
+// smallest head, so replacing the winner's head replays only the log2(k)
+// matches on its path, one comparison each. Sources hand in a pointer to
+// their current head, or nullptr once exhausted; ties go to the lower
+// source index, which keeps the merge stable when runs are numbered in
+// input order.
+template <typename T, typename Comparator>
+class LoserTree
+{
+private:
+    std::vector<const T *> _heads;
+    std::vector<size_t> _losers;
+    size_t _winner;
+    Comparator _comparator;
+
+    bool beats(size_t a, size_t b) const;
+
+public:
+    LoserTree(const std::vector<const T *> &heads, Comparator comparator);
+
+    // winner() - Source with the smallest head; only valid while !exhausted()
+    size_t winner() const;
+    bool exhausted() const;
+    // replace_winner() - Gives the winner its next head, nullptr if it has none, and replays its path
+    void replace_winner(const T *head);
+};
+
+// external_sort() - Sorts the records of the file at input_path into
+// output_path, which may be the same file, holding about
+// options.memory_budget bytes in memory at a time. The first pass reads
+// the input in chunks that fill the budget, sorts each chunk on pool,
+// and spills it to a temporary run file. Chunks take the parallel
+// merge_sort, or the faster unstable kernels for integer and string
+// records ordered by std::less or std::greater, where ties are identical.
+// Runs are then merged k at a time through a LoserTree, with a large
+// sequential buffer per run, in as many passes as the budget needs; the
+// run files are removed as they are consumed. Stable: equal records keep
+// their input order. Lines are written back newline-terminated. Throws
+// std::runtime_error on I/O failures, leaving no temporary files behind.
+template <typename T, typename Comparator>
+ExternalSortStats external_sort(WorkStealingPool &pool, const std::string &input_path, const std::string &output_path,
+                                Comparator comparator, const ExternalSortOptions &options = ExternalSortOptions());
+
+#endif
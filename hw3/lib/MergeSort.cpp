@@ -0,0 +1,412 @@
+#ifndef MERGE_SORT_CPP
+#define MERGE_SORT_CPP
+
+#include "MergeSort.hpp"
+#include "ThreadPool.cpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Natural runs shorter than the minimum run length, which lies between
+// MIN_RUN_BASE / 2 and MIN_RUN_BASE, are extended by insertion sort
+const ptrdiff_t MIN_RUN_BASE = 64;
+// Pieces of parallel work hold at least this many elements
+const ptrdiff_t PARALLEL_MERGE_GRAIN = 1 << 14;
+
+// Scratch space for merges, never holding more than limit elements
+template <typename T>
+struct MergeBuffer
+{
+    std::vector<T> elements;
+    size_t limit;
+};
+
+// min_run_length() - TimSort's choice of minimum run length: length
+// divided by a power of two, so that the runs come out as a power of two
+// in number or slightly fewer and the final merges stay balanced
+inline ptrdiff_t min_run_length(ptrdiff_t length)
+{
+    ptrdiff_t odd = 0;
+    while (length >= MIN_RUN_BASE)
+    {
+        odd |= length & 1;
+        length >>= 1;
+    }
+    return length + odd;
+}
+
+// extend_run() - Extends the sorted prefix [first, sorted_end) to [first,
+// last) by insertion sort, each element going after any equal ones. A
+// linear scan rather than TimSort's binary search: runs are short, and its
+// one mispredicted branch per element beats the search's several.
+template <typename RandomAccessIter, typename Comparator>
+void extend_run(RandomAccessIter first, RandomAccessIter sorted_end, RandomAccessIter last, Comparator &comparator)
+{
+    for (RandomAccessIter i = sorted_end; i != last; ++i)
+    {
+        auto value = std::move(*i);
+        RandomAccessIter position = i;
+        for (; position != first && comparator(value, *std::prev(position)); --position)
+            *position = std::move(*std::prev(position));
+        *position = std::move(value);
+    }
+}
+
+// count_run() - Returns the end of the natural run starting at first. A
+// strictly descending run is reversed in place; equal elements never
+// extend one, so reversing cannot reorder them.
+template <typename RandomAccessIter, typename Comparator>
+RandomAccessIter count_run(RandomAccessIter first, RandomAccessIter last, Comparator &comparator)
+{
+    RandomAccessIter run_end = std::next(first);
+    if (run_end == last)
+        return last;
+
+    if (comparator(*run_end, *first))
+    {
+        while (++run_end != last && comparator(*run_end, *std::prev(run_end)))
+            ;
+        std::reverse(first, run_end);
+    }
+    else
+    {
+        while (++run_end != last && !comparator(*run_end, *std::prev(run_end)))
+            ;
+    }
+    return run_end;
+}
+
+// merge_low() - Merges with the left run, the shorter one, moved to the
+// buffer. merge_adjacent() has trimmed the runs so that the left one ends
+// above every element of the right one, which therefore runs out first.
+template <typename RandomAccessIter, typename Comparator, typename T>
+void merge_low(RandomAccessIter first, RandomAccessIter middle, RandomAccessIter last, Comparator &comparator,
+               MergeBuffer<T> &buffer)
+{
+    buffer.elements.assign(std::make_move_iterator(first), std::make_move_iterator(middle));
+    auto left = buffer.elements.begin();
+    auto left_end = buffer.elements.end();
+    RandomAccessIter right = middle;
+    RandomAccessIter out = first;
+    while (right != last)
+    {
+        // Ties go to the left run
+        if (comparator(*right, *left))
+            *out++ = std::move(*right++);
+        else
+            *out++ = std::move(*left++);
+    }
+    std::move(left, left_end, out);
+}
+
+// merge_high() - Merges from the back with the right run, the shorter one,
+// moved to the buffer. The right run starts below every element of the
+// left one, so the left one runs out first.
+template <typename RandomAccessIter, typename Comparator, typename T>
+void merge_high(RandomAccessIter first, RandomAccessIter middle, RandomAccessIter last, Comparator &comparator,
+                MergeBuffer<T> &buffer)
+{
+    buffer.elements.assign(std::make_move_iterator(middle), std::make_move_iterator(last));
+    auto right_begin = buffer.elements.begin();
+    auto right = buffer.elements.end();
+    RandomAccessIter left = middle;
+    RandomAccessIter out = last;
+    while (left != first)
+    {
+        // Ties go to the right run, which fills from the back
+        if (comparator(*std::prev(right), *std::prev(left)))
+            *--out = std::move(*--left);
+        else
+            *--out = std::move(*--right);
+    }
+    std::move_backward(right_begin, right, out);
+}
+
+// merge_adjacent() - Stably merges the sorted runs [first, middle) and
+// [middle, last). Binary searches first drop the elements already in
+// place: the left run's prefix not above the right run's first element and
+// the right run's suffix not below the left run's last. If the shorter
+// remainder exceeds the buffer limit, the merge is split in two by a
+// rotation and each half merged on its own.
+template <typename RandomAccessIter, typename Comparator, typename T>
+void merge_adjacent(RandomAccessIter first, RandomAccessIter middle, RandomAccessIter last, Comparator &comparator,
+                    MergeBuffer<T> &buffer)
+{
+    if (first == middle || middle == last)
+        return;
+    first = std::upper_bound(first, middle, *middle, comparator);
+    if (first == middle)
+        return;
+    last = std::lower_bound(middle, last, *std::prev(middle), comparator);
+
+    ptrdiff_t left_length = middle - first;
+    ptrdiff_t right_length = last - middle;
+    if (static_cast<size_t>(std::min(left_length, right_length)) <= buffer.limit)
+    {
+        if (left_length <= right_length)
+            merge_low(first, middle, last, comparator, buffer);
+        else
+            merge_high(first, middle, last, comparator, buffer);
+        return;
+    }
+
+    if (left_length == 1 && right_length == 1)
+    {
+        std::iter_swap(first, middle);
+        return;
+    }
+
+    RandomAccessIter left_cut;
+    RandomAccessIter right_cut;
+    if (left_length > right_length)
+    {
+        left_cut = first + left_length / 2;
+        right_cut = std::lower_bound(middle, last, *left_cut, comparator);
+    }
+    else
+    {
+        right_cut = middle + right_length / 2;
+        left_cut = std::upper_bound(first, middle, *right_cut, comparator);
+    }
+    RandomAccessIter new_middle = std::rotate(left_cut, middle, right_cut);
+    merge_adjacent(first, left_cut, new_middle, comparator, buffer);
+    merge_adjacent(new_middle, right_cut, last, comparator, buffer);
+}
+
+// adaptive_merge_sort() - The TimSort driver: finds the runs left to right
+// and keeps their lengths on a stack where each is above the sum of the
+// two on top of it and above the one right on top, merging until that
+// holds again after every push. Runs therefore merge with runs of similar
+// length, and the stack stays O(log n) deep.
+template <typename RandomAccessIter, typename Comparator, typename T>
+void adaptive_merge_sort(RandomAccessIter first, RandomAccessIter last, Comparator &comparator,
+                         MergeBuffer<T> &buffer)
+{
+    ptrdiff_t length = std::distance(first, last);
+    if (length < 2)
+        return;
+    ptrdiff_t min_run = min_run_length(length);
+
+    struct Run
+    {
+        RandomAccessIter first;
+        ptrdiff_t length;
+    };
+    std::vector<Run> runs;
+
+    // merge_at() - Merges run i with run i + 1
+    auto merge_at = [&](size_t i)
+    {
+        RandomAccessIter middle = runs[i + 1].first;
+        merge_adjacent(runs[i].first, middle, middle + runs[i + 1].length, comparator, buffer);
+        runs[i].length += runs[i + 1].length;
+        runs.erase(runs.begin() + i + 1);
+    };
+
+    for (RandomAccessIter current = first; current != last;)
+    {
+        RandomAccessIter run_end = count_run(current, last, comparator);
+        if (run_end - current < min_run)
+        {
+            RandomAccessIter forced_end = current + std::min(min_run, last - current);
+            extend_run(current, run_end, forced_end, comparator);
+            run_end = forced_end;
+        }
+        runs.push_back({current, run_end - current});
+        current = run_end;
+
+        while (runs.size() > 1)
+        {
+            size_t i = runs.size() - 2;
+            if ((i >= 1 && runs[i - 1].length <= runs[i].length + runs[i + 1].length) ||
+                (i >= 2 && runs[i - 2].length <= runs[i - 1].length + runs[i].length))
+            {
+                if (runs[i - 1].length < runs[i + 1].length)
+                    i--;
+            }
+            else if (runs[i].length > runs[i + 1].length)
+            {
+                break;
+            }
+            merge_at(i);
+        }
+    }
+
+    while (runs.size() > 1)
+        merge_at(runs.size() - 2);
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    merge_sort(first, last, comparator, std::numeric_limits<size_t>::max());
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator, size_t buffer_limit)
+{
+    using T = typename std::iterator_traits<RandomAccessIter>::value_type;
+    MergeBuffer<T> buffer{{}, buffer_limit};
+    adaptive_merge_sort(first, last, comparator, buffer);
+}
+
+// merge_path_split() - Number of elements the first d elements of the
+// stable merge of [left, left + left_length) and [right, right +
+// right_length) take from the left run, found by binary search along the
+// merge path
+template <typename LeftIter, typename RightIter, typename Comparator>
+ptrdiff_t merge_path_split(LeftIter left, ptrdiff_t left_length, RightIter right, ptrdiff_t right_length,
+                           ptrdiff_t d, Comparator &comparator)
+{
+    ptrdiff_t low = std::max<ptrdiff_t>(0, d - right_length);
+    ptrdiff_t high = std::min(d, left_length);
+    while (low < high)
+    {
+        // Taking i from the left is too few if right[j - 1] does not sort strictly before left[i]
+        ptrdiff_t i = low + (high - low) / 2;
+        ptrdiff_t j = d - i;
+        if (j > 0 && !comparator(right[j - 1], left[i]))
+            low = i + 1;
+        else
+            high = i;
+    }
+    return low;
+}
+
+// move_merge() - Stably merges two sorted ranges into out by moving
+template <typename InputIter, typename OutputIter, typename Comparator>
+void move_merge(InputIter left, InputIter left_end, InputIter right, InputIter right_end, OutputIter out,
+                Comparator &comparator)
+{
+    while (left != left_end && right != right_end)
+    {
+        if (comparator(*right, *left))
+            *out++ = std::move(*right++);
+        else
+            *out++ = std::move(*left++);
+    }
+    out = std::move(left, left_end, out);
+    std::move(right, right_end, out);
+}
+
+// parallel_move() - Moves [from, from_end) to to in grain-sized tasks of group
+template <typename InputIter, typename OutputIter>
+void parallel_move(TaskGroup &group, InputIter from, InputIter from_end, OutputIter to)
+{
+    ptrdiff_t length = std::distance(from, from_end);
+    for (ptrdiff_t begin = 0; begin < length; begin += PARALLEL_MERGE_GRAIN)
+    {
+        ptrdiff_t end = std::min(length, begin + PARALLEL_MERGE_GRAIN);
+        group.run([from, to, begin, end]()
+                  { std::move(from + begin, from + end, to + begin); });
+    }
+}
+
+// parallel_merge() - Merges the sorted [from + begin, from + middle) and
+// [from + middle, from + end) into to + begin, cut along the merge path
+// into grain-sized pieces that are tasks of group. All the cuts are found
+// before any piece starts moving elements out of from.
+template <typename InputIter, typename OutputIter, typename Comparator>
+void parallel_merge(TaskGroup &group, InputIter from, OutputIter to, ptrdiff_t begin, ptrdiff_t middle,
+                    ptrdiff_t end, Comparator comparator)
+{
+    InputIter left = from + begin;
+    InputIter right = from + middle;
+    ptrdiff_t left_length = middle - begin;
+    ptrdiff_t right_length = end - middle;
+    ptrdiff_t pieces = (end - begin + PARALLEL_MERGE_GRAIN - 1) / PARALLEL_MERGE_GRAIN;
+
+    std::vector<std::pair<ptrdiff_t, ptrdiff_t>> cuts;
+    for (ptrdiff_t piece = 0; piece <= pieces; piece++)
+    {
+        ptrdiff_t d = (end - begin) * piece / pieces;
+        ptrdiff_t i = merge_path_split(left, left_length, right, right_length, d, comparator);
+        cuts.emplace_back(i, d - i);
+    }
+
+    for (ptrdiff_t piece = 0; piece < pieces; piece++)
+    {
+        auto [i_begin, j_begin] = cuts[piece];
+        auto [i_end, j_end] = cuts[piece + 1];
+        OutputIter out = to + begin + i_begin + j_begin;
+        group.run([=]() mutable
+                  { move_merge(left + i_begin, left + i_end, right + j_begin, right + j_end, out, comparator); });
+    }
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    using T = typename std::iterator_traits<RandomAccessIter>::value_type;
+    ptrdiff_t length = std::distance(first, last);
+    if (length < 2 * PARALLEL_MERGE_GRAIN)
+    {
+        merge_sort(first, last, comparator);
+        return;
+    }
+
+    // Chunk boundaries; each round merges neighbouring chunks in pairs
+    ptrdiff_t chunks = std::min(static_cast<ptrdiff_t>(pool.size() * 4), length / PARALLEL_MERGE_GRAIN);
+    std::vector<ptrdiff_t> bounds;
+    for (ptrdiff_t i = 0; i <= chunks; i++)
+        bounds.push_back(length * i / chunks);
+
+    TaskGroup group(pool);
+    for (ptrdiff_t i = 0; i < chunks; i++)
+    {
+        RandomAccessIter chunk_first = first + bounds[i];
+        RandomAccessIter chunk_last = first + bounds[i + 1];
+        group.run([chunk_first, chunk_last, comparator]()
+                  { merge_sort(chunk_first, chunk_last, comparator); });
+    }
+    group.wait();
+
+    // Rounds alternate between the range and the buffer; a buffer that
+    // cannot be default-constructed starts out holding the elements
+    std::vector<T> buffer;
+    bool in_buffer = false;
+    if constexpr (std::is_default_constructible_v<T>)
+    {
+        buffer.resize(length);
+    }
+    else
+    {
+        buffer.assign(std::make_move_iterator(first), std::make_move_iterator(last));
+        in_buffer = true;
+    }
+
+    auto merge_round = [&](auto from, auto to)
+    {
+        std::vector<ptrdiff_t> merged;
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2)
+        {
+            merged.push_back(bounds[i]);
+            if (i + 2 < bounds.size())
+                parallel_merge(group, from, to, bounds[i], bounds[i + 1], bounds[i + 2], comparator);
+            else
+                parallel_move(group, from + bounds[i], from + bounds[i + 1], to + bounds[i]);
+        }
+        merged.push_back(length);
+        group.wait();
+        bounds = std::move(merged);
+    };
+
+    while (bounds.size() > 2)
+    {
+        if (in_buffer)
+            merge_round(buffer.begin(), first);
+        else
+            merge_round(first, buffer.begin());
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer)
+    {
+        parallel_move(group, buffer.begin(), buffer.end(), first);
+        group.wait();
+    }
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MERGE_SORT_HPP
+#define MERGE_SORT_HPP
+
+#include "ThreadPool.hpp"
+#include <cstddef>
+
+// merge_sort() - Stable sort of [first, last) by comparator: elements that
+// compare equal keep their order, so sorting by a secondary key and then
+// by a primary one gives a multi-key order. Adaptive, in the manner of
+// TimSort: the range is cut into natural runs (ascending, or strictly
+// descending and then reversed), short runs are extended by insertion
+// sort, and runs are merged under TimSort's stack invariants.
+// Each merge first skips the elements already in place at both ends, so
+// input made of few runs, like mostly ordered logs, sorts in close to
+// linear time; the worst case is O(n log n) comparisons. Uses a buffer of
+// up to n / 2 elements.
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator);
+
+// merge_sort() - As above, but never buffers more than buffer_limit
+// elements. Merges that do not fit are split by rotations until their
+// pieces do, at O(log n) extra cost per level; with a limit of 0 the sort
+// runs fully in place in O(n log^2 n).
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator, size_t buffer_limit);
+
+// merge_sort() - Parallel version on pool. Chunks of the range are sorted
+// as separate tasks, then merged pairwise in rounds; each merge is cut
+// along its merge path into pieces that are merged in parallel, so every
+// round keeps all workers busy. Stable, with a buffer of n elements.
+template <typename RandomAccessIter, typename Comparator>
+void merge_sort(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last, Comparator comparator);
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef RADIX_SORT_CPP
+#define RADIX_SORT_CPP
+
+#include "RadixSort.hpp"
+#include "qsort.cpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Ranges below these sizes are left to quick_sort by dispatch_sort(); a
+// radix pass per key byte pays off from about 256 keys per byte
+const ptrdiff_t RADIX_SORT_THRESHOLD_PER_BYTE = 256;
+const ptrdiff_t STRING_RADIX_SORT_THRESHOLD = 1 << 10;
+// String buckets at or below this size are finished by insertion sort
+const ptrdiff_t STRING_INSERTION_THRESHOLD = 32;
+
+// to_radix_key() - Maps key to an unsigned integer of the same width and
+// the same order: signed integers get their sign bit flipped, and floats
+// their sign bit flipped when positive or all bits flipped when negative
+template <typename T>
+auto to_radix_key(T key)
+{
+    static_assert(is_radix_key_v<T>, "radix keys are integers, float or double");
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        const Bits sign = Bits(1) << (8 * sizeof(Bits) - 1);
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return (bits & sign) != 0 ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+    }
+    else if constexpr (std::is_signed_v<T>)
+    {
+        using Bits = std::make_unsigned_t<T>;
+        return static_cast<Bits>(static_cast<Bits>(key) ^ (Bits(1) << (8 * sizeof(Bits) - 1)));
+    }
+    else
+    {
+        return key;
+    }
+}
+
+// lsd_radix_sort() - Stable LSD radix sort by radix_key_of(element), an
+// unsigned integer, one byte per pass, least significant first. Bytes that
+// are the same for every key are skipped, so narrow ranges of wide keys
+// (ids, timestamps) take only the passes their spread needs.
+template <typename RandomAccessIter, typename RadixKeyOf>
+void lsd_radix_sort(RandomAccessIter first, RandomAccessIter last, RadixKeyOf radix_key_of)
+{
+    using Value = typename std::iterator_traits<RandomAccessIter>::value_type;
+    using Key = decltype(radix_key_of(*first));
+    constexpr size_t DIGITS = sizeof(Key);
+
+    ptrdiff_t length = std::distance(first, last);
+    if (length <= 1)
+        return;
+
+    size_t counts[DIGITS][256] = {};
+    for (RandomAccessIter i = first; i != last; ++i)
+    {
+        Key key = radix_key_of(*i);
+        for (size_t digit = 0; digit < DIGITS; digit++)
+            counts[digit][(key >> (8 * digit)) & 0xFF]++;
+    }
+
+    std::vector<size_t> passes;
+    Key sample = radix_key_of(*first);
+    for (size_t digit = 0; digit < DIGITS; digit++)
+    {
+        if (counts[digit][(sample >> (8 * digit)) & 0xFF] != static_cast<size_t>(length))
+            passes.push_back(digit);
+    }
+    if (passes.empty())
+        return;
+
+    // Passes alternate between the range and the buffer; a buffer that
+    // cannot be default-constructed starts out holding the elements
+    std::vector<Value> buffer;
+    bool in_buffer = false;
+    if constexpr (std::is_default_constructible_v<Value>)
+    {
+        buffer.resize(length);
+    }
+    else
+    {
+        buffer.assign(std::make_move_iterator(first), std::make_move_iterator(last));
+        in_buffer = true;
+    }
+
+    for (size_t digit : passes)
+    {
+        size_t offsets[256];
+        size_t total = 0;
+        for (size_t bucket = 0; bucket < 256; bucket++)
+        {
+            offsets[bucket] = total;
+            total += counts[digit][bucket];
+        }
+
+        auto scatter = [&](auto from, auto from_end, auto to)
+        {
+            for (; from != from_end; ++from)
+            {
+                size_t bucket = (radix_key_of(*from) >> (8 * digit)) & 0xFF;
+                to[offsets[bucket]++] = std::move(*from);
+            }
+        };
+        if (in_buffer)
+            scatter(buffer.begin(), buffer.end(), first);
+        else
+            scatter(first, last, buffer.begin());
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer)
+        std::move(buffer.begin(), buffer.end(), first);
+}
+
+// american_flag_sort() - In-place MSD radix sort of strings. Each range is
+// split into 257 buckets by the byte at its depth (bucket 0 holding the
+// strings that end there) with counting and cycle-following swaps; every
+// bucket but the first is then sorted one byte deeper. Pending buckets go
+// on an explicit stack, so long shared prefixes cannot overflow the call
+// stack, and small buckets are finished by insertion sort.
+template <typename RandomAccessIter>
+void american_flag_sort(RandomAccessIter first, RandomAccessIter last)
+{
+    struct Bucket
+    {
+        RandomAccessIter first;
+        RandomAccessIter last;
+        size_t depth;
+    };
+    std::vector<Bucket> pending{{first, last, 0}};
+
+    while (!pending.empty())
+    {
+        Bucket range = pending.back();
+        pending.pop_back();
+        size_t depth = range.depth;
+
+        // Every string of the range has the same first depth bytes
+        if (range.last - range.first <= STRING_INSERTION_THRESHOLD)
+        {
+            insertion_sort(range.first, range.last, [depth](const auto &a, const auto &b)
+                           { return std::string_view(a).substr(depth) < std::string_view(b).substr(depth); });
+            continue;
+        }
+
+        auto bucket_of = [depth](const auto &s) -> size_t
+        {
+            return depth < s.size() ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+        };
+
+        size_t counts[257] = {};
+        for (RandomAccessIter i = range.first; i != range.last; ++i)
+            counts[bucket_of(*i)]++;
+
+        RandomAccessIter starts[258];
+        RandomAccessIter heads[257];
+        starts[0] = range.first;
+        for (size_t bucket = 0; bucket < 257; bucket++)
+        {
+            heads[bucket] = starts[bucket];
+            starts[bucket + 1] = starts[bucket] + counts[bucket];
+        }
+
+        // Swap each string into the next free slot of its bucket until
+        // every bucket is filled
+        for (size_t bucket = 0; bucket < 257; bucket++)
+        {
+            while (heads[bucket] != starts[bucket + 1])
+            {
+                size_t target = bucket_of(*heads[bucket]);
+                if (target == bucket)
+                    ++heads[bucket];
+                else
+                    std::iter_swap(heads[bucket], heads[target]++);
+            }
+        }
+
+        for (size_t bucket = 1; bucket < 257; bucket++)
+        {
+            if (counts[bucket] > 1)
+                pending.push_back({starts[bucket], starts[bucket + 1], depth + 1});
+        }
+    }
+}
+
+template <typename RandomAccessIter>
+void radix_sort(RandomAccessIter first, RandomAccessIter last)
+{
+    using T = typename std::iterator_traits<RandomAccessIter>::value_type;
+    static_assert(is_radix_key_v<T> || is_radix_string_v<T>,
+                  "radix_sort() sorts integer, floating-point and string keys; pass a key_of for other elements");
+
+    if constexpr (is_radix_string_v<T>)
+        american_flag_sort(first, last);
+    else
+        lsd_radix_sort(first, last, [](T key)
+                       { return to_radix_key(key); });
+}
+
+template <typename RandomAccessIter, typename KeyOf>
+void radix_sort(RandomAccessIter first, RandomAccessIter last, KeyOf key_of)
+{
+    lsd_radix_sort(first, last, [&key_of](const auto &element)
+                   { return to_radix_key(key_of(element)); });
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void dispatch_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    using Radix = RadixSortable<RandomAccessIter, Comparator>;
+    if constexpr (Radix::value)
+    {
+        using T = typename Radix::key_type;
+        ptrdiff_t length = std::distance(first, last);
+        if constexpr (is_radix_string_v<T>)
+        {
+            if (length >= STRING_RADIX_SORT_THRESHOLD)
+            {
+                american_flag_sort(first, last);
+                if (Radix::descending)
+                    std::reverse(first, last);
+                return;
+            }
+        }
+        else if (length >= RADIX_SORT_THRESHOLD_PER_BYTE * static_cast<ptrdiff_t>(sizeof(T)) &&
+                 !(SimdSortable<RandomAccessIter, Comparator>::value && simd_sort_supported()))
+        {
+            // Descending order is ascending order of the complemented keys
+            lsd_radix_sort(first, last, [](T key)
+                           {
+                auto radix_key = to_radix_key(key);
+                return Radix::descending ? static_cast<decltype(radix_key)>(~radix_key) : radix_key; });
+            return;
+        }
+    }
+    quick_sort(first, last, comparator);
+}
+
+#endif
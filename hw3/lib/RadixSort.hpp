@@ -0,0 +1,58 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Fixed-width keys radix_sort() handles digit by digit: integers other than
+// bool, float and double
+template <typename T>
+constexpr bool is_radix_key_v =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Strings radix_sort() handles byte by byte, in std::string order
+template <typename T>
+constexpr bool is_radix_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+// Whether dispatch_sort() may radix sort [first, last) with comparator: keys
+// of either kind ordered by std::less or std::greater
+template <typename RandomAccessIter, typename Comparator>
+struct RadixSortable
+{
+    using key_type = typename std::iterator_traits<RandomAccessIter>::value_type;
+
+    static constexpr bool ascending =
+        std::is_same_v<Comparator, std::less<key_type>> || std::is_same_v<Comparator, std::less<>>;
+    static constexpr bool descending =
+        std::is_same_v<Comparator, std::greater<key_type>> || std::is_same_v<Comparator, std::greater<>>;
+    static constexpr bool value = (is_radix_key_v<key_type> || is_radix_string_v<key_type>) && (ascending || descending);
+};
+
+// radix_sort() - Sorts [first, last) ascending. Fixed-width keys take an
+// LSD radix sort: one counting pass builds the histograms of all bytes,
+// then each byte that is not the same for every key costs one stable
+// scatter into a buffer of n elements. Strings take an in-place MSD
+// (American flag) radix sort. O(n * key bytes) time either way.
+template <typename RandomAccessIter>
+void radix_sort(RandomAccessIter first, RandomAccessIter last);
+
+// radix_sort() - Stable LSD sort of [first, last) ascending by
+// key_of(element), which must return a fixed-width key
+template <typename RandomAccessIter, typename KeyOf>
+void radix_sort(RandomAccessIter first, RandomAccessIter last, KeyOf key_of);
+
+// dispatch_sort() - Sorts [first, last) by comparator with whichever of
+// radix_sort() and quick_sort() suits the keys: radix sort for integer,
+// floating-point and string keys ordered by std::less or std::greater once
+// the range is large enough to amortize its passes, quick_sort otherwise.
+// Keys quick_sort partitions with vector instructions stay with quick_sort,
+// which keeps up with the radix passes without their extra buffer.
+template <typename RandomAccessIter, typename Comparator>
+void dispatch_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator);
+
+#endif
@@ -0,0 +1,493 @@
+#ifndef SIMD_PARTITION_CPP
+#define SIMD_PARTITION_CPP
+
+#include "SimdPartition.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#if SIMD_PARTITION_X86
+#include <immintrin.h>
+#endif
+
+// selects() - Whether a kernel moves key to the front: keys ordered before
+// pivot, and with OrEqual also keys equal to it
+template <typename T, bool Descending, bool OrEqual>
+inline bool selects(T key, T pivot)
+{
+    if constexpr (OrEqual)
+        return Descending ? !(pivot > key) : !(pivot < key);
+    else
+        return Descending ? key > pivot : key < pivot;
+}
+
+// partition_scalar() - Kernel for ranges too short to fill the vectors
+template <typename T, bool Descending, bool OrEqual>
+T *partition_scalar(T *first, T *last, T pivot)
+{
+    return std::partition(first, last, [pivot](T key)
+                          { return selects<T, Descending, OrEqual>(key, pivot); });
+}
+
+// place_remaining() - Fills the gap [left, right), which must be exactly
+// count slots long, with keys: selected ones from the left end and the
+// others from the right end. Returns the split.
+template <typename T, bool Descending, bool OrEqual>
+T *place_remaining(T *left, T *right, const T *keys, size_t count, T pivot)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // Writing both ends is safe while the gap is not full, and avoids a branch
+        bool selected = selects<T, Descending, OrEqual>(keys[i], pivot);
+        *left = keys[i];
+        right[-1] = keys[i];
+        left += selected;
+        right -= !selected;
+    }
+    return left;
+}
+
+#if SIMD_PARTITION_X86
+
+// Lane orders that pack the lanes set in a mask to the front and the others
+// behind them, both in their original order; one byte per 32-bit lane
+struct CompressTable
+{
+    uint64_t lanes32[256];
+    uint64_t lanes64[16];
+};
+
+constexpr CompressTable make_compress_table()
+{
+    CompressTable table{};
+    for (unsigned mask = 0; mask < 256; mask++)
+    {
+        int out = 0;
+        for (unsigned wanted : {1u, 0u})
+        {
+            for (unsigned lane = 0; lane < 8; lane++)
+            {
+                if (((mask >> lane) & 1) == wanted)
+                    table.lanes32[mask] |= static_cast<uint64_t>(lane) << (8 * out++);
+            }
+        }
+    }
+    // A 64-bit lane moves as the pair of 32-bit lanes it covers
+    for (unsigned mask = 0; mask < 16; mask++)
+    {
+        int out = 0;
+        for (unsigned wanted : {1u, 0u})
+        {
+            for (unsigned lane = 0; lane < 4; lane++)
+            {
+                if (((mask >> lane) & 1) == wanted)
+                {
+                    table.lanes64[mask] |= static_cast<uint64_t>(2 * lane) << (8 * out++);
+                    table.lanes64[mask] |= static_cast<uint64_t>(2 * lane + 1) << (8 * out++);
+                }
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr CompressTable COMPRESS_TABLE = make_compress_table();
+
+// Bitonic sorting network over the lanes of a GCC generic vector of BYTES
+// bytes. A compare-exchange step is a lane shuffle, a min, a max and a
+// blend, with no data-dependent branches, and each merge starts by
+// comparing mirrored lanes, so all comparators point the same way. The
+// members are always inlined: they compile to the instruction set of the
+// kernel that calls them.
+template <typename T, size_t BYTES, bool Descending>
+struct VectorNetwork
+{
+    static constexpr size_t COUNT = BYTES / sizeof(T);
+    using Index = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+    typedef T Vec __attribute__((vector_size(BYTES)));
+    typedef Index Lanes __attribute__((vector_size(BYTES)));
+
+    // order() - Leaves, lane by lane, the key that sorts first in low and the other in high
+    [[gnu::always_inline]] static inline void order(Vec &low, Vec &high)
+    {
+        Lanes in_order = Descending ? low > high : low < high;
+        Vec first = in_order ? low : high;
+        high = in_order ? high : low;
+        low = first;
+    }
+
+    // compare_exchange() - Orders lane i against lane i ^ PARTNER; the lane
+    // with LOWER_BIT clear keeps the key that sorts first
+    template <size_t PARTNER, size_t LOWER_BIT>
+    [[gnu::always_inline]] static inline void compare_exchange(Vec &keys)
+    {
+        Lanes partner;
+        Lanes lower;
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            partner[i] = static_cast<Index>(i ^ PARTNER);
+            lower[i] = (i & LOWER_BIT) == 0 ? -1 : 0;
+        }
+        Vec low = keys;
+        Vec high = __builtin_shuffle(keys, partner);
+        order(low, high);
+        keys = lower ? low : high;
+    }
+
+    // merge() - Sorts lanes that hold bitonic sequences of 2 * STEP keys
+    template <size_t STEP>
+    [[gnu::always_inline]] static inline void merge(Vec &keys)
+    {
+        if constexpr (STEP > 0)
+        {
+            compare_exchange<STEP, STEP>(keys);
+            merge<STEP / 2>(keys);
+        }
+    }
+
+    template <size_t BLOCK = 2>
+    [[gnu::always_inline]] static inline void sort_lanes(Vec &keys)
+    {
+        if constexpr (BLOCK <= COUNT)
+        {
+            compare_exchange<BLOCK - 1, BLOCK / 2>(keys);
+            merge<BLOCK / 4>(keys);
+            sort_lanes<BLOCK * 2>(keys);
+        }
+    }
+
+    // sort() - Sorts up to 2 * COUNT keys: each vector on its own, then
+    // both together after mirroring the second
+    [[gnu::always_inline]] static inline void sort(T *first, T *last)
+    {
+        size_t count = last - first;
+        if (count <= 1)
+            return;
+
+        // Padding sorts behind every key
+        T padding;
+        if constexpr (std::numeric_limits<T>::has_infinity)
+            padding = Descending ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+        else
+            padding = Descending ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+
+        Vec keys[2];
+        for (size_t i = 0; i < COUNT; i++)
+            keys[0][i] = keys[1][i] = padding;
+        std::memcpy(keys, first, count * sizeof(T));
+
+        sort_lanes(keys[0]);
+        if (count > COUNT)
+        {
+            Lanes mirror;
+            for (size_t i = 0; i < COUNT; i++)
+                mirror[i] = static_cast<Index>(COUNT - 1 - i);
+            sort_lanes(keys[1]);
+            keys[1] = __builtin_shuffle(keys[1], mirror);
+            order(keys[0], keys[1]);
+            merge<COUNT / 2>(keys[0]);
+            merge<COUNT / 2>(keys[1]);
+        }
+        std::memcpy(first, keys, count * sizeof(T));
+    }
+};
+
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+
+inline __m256i compress_order32(unsigned mask)
+{
+    return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(COMPRESS_TABLE.lanes32[mask])));
+}
+
+inline __m256i compress_order64(unsigned mask)
+{
+    return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(COMPRESS_TABLE.lanes64[mask])));
+}
+
+// AVX2 has no compress instruction: compress() permutes the selected lanes
+// to the front through COMPRESS_TABLE instead
+template <typename T>
+struct Avx2Lanes;
+
+template <>
+struct Avx2Lanes<int32_t>
+{
+    using Vec = __m256i;
+    static constexpr int COUNT = 8;
+
+    static Vec load(const int32_t *from) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from)); }
+    static void store(int32_t *to, Vec keys) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(to), keys); }
+    static Vec splat(int32_t key) { return _mm256_set1_epi32(key); }
+    static unsigned less(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))); }
+    static Vec compress(Vec keys, unsigned mask) { return _mm256_permutevar8x32_epi32(keys, compress_order32(mask)); }
+};
+
+template <>
+struct Avx2Lanes<float>
+{
+    using Vec = __m256;
+    static constexpr int COUNT = 8;
+
+    static Vec load(const float *from) { return _mm256_loadu_ps(from); }
+    static void store(float *to, Vec keys) { _mm256_storeu_ps(to, keys); }
+    static Vec splat(float key) { return _mm256_set1_ps(key); }
+    static unsigned less(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static Vec compress(Vec keys, unsigned mask) { return _mm256_permutevar8x32_ps(keys, compress_order32(mask)); }
+};
+
+template <>
+struct Avx2Lanes<double>
+{
+    using Vec = __m256d;
+    static constexpr int COUNT = 4;
+
+    static Vec load(const double *from) { return _mm256_loadu_pd(from); }
+    static void store(double *to, Vec keys) { _mm256_storeu_pd(to, keys); }
+    static Vec splat(double key) { return _mm256_set1_pd(key); }
+    static unsigned less(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    static Vec compress(Vec keys, unsigned mask)
+    {
+        return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(keys), compress_order64(mask)));
+    }
+};
+
+template <>
+struct Avx2Lanes<uint64_t>
+{
+    using Vec = __m256i;
+    static constexpr int COUNT = 4;
+
+    static Vec load(const uint64_t *from) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(from)); }
+    static void store(uint64_t *to, Vec keys) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(to), keys); }
+    static Vec splat(uint64_t key) { return _mm256_set1_epi64x(static_cast<long long>(key)); }
+    // Only a signed compare exists; flipping the sign bits makes it an unsigned one
+    static unsigned less(Vec a, Vec b)
+    {
+        const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+        __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+        return _mm256_movemask_pd(_mm256_castsi256_pd(greater));
+    }
+    static Vec compress(Vec keys, unsigned mask) { return _mm256_permutevar8x32_epi32(keys, compress_order64(mask)); }
+};
+
+// partition_avx2() - Vectorized partition. The first and last vector of
+// keys are set aside, which opens 2 vectors of free slots. Each step loads
+// one vector from whichever end has fewer free slots, so both ends keep at
+// least a vector of room, and stores it packed twice: to the left end,
+// where its selected keys count, and to the right end, where the others do.
+// The leftover keys fill the final gap.
+template <typename T, bool Descending, bool OrEqual>
+T *partition_avx2(T *first, T *last, T pivot)
+{
+    using Lanes = Avx2Lanes<T>;
+    constexpr ptrdiff_t WIDTH = Lanes::COUNT;
+    constexpr unsigned ALL = (1u << WIDTH) - 1;
+    if (last - first < 2 * WIDTH)
+        return partition_scalar<T, Descending, OrEqual>(first, last, pivot);
+
+    T remaining[3 * WIDTH];
+    std::memcpy(remaining, first, WIDTH * sizeof(T));
+    std::memcpy(remaining + WIDTH, last - WIDTH, WIDTH * sizeof(T));
+
+    T *read_left = first + WIDTH;
+    T *read_right = last - WIDTH;
+    T *write_left = first;
+    T *write_right = last;
+    typename Lanes::Vec pivots = Lanes::splat(pivot);
+    while (read_right - read_left >= WIDTH)
+    {
+        typename Lanes::Vec keys;
+        if (read_left - write_left <= write_right - read_right)
+        {
+            keys = Lanes::load(read_left);
+            read_left += WIDTH;
+        }
+        else
+        {
+            read_right -= WIDTH;
+            keys = Lanes::load(read_right);
+        }
+
+        unsigned mask;
+        if constexpr (OrEqual)
+            mask = ALL & ~(Descending ? Lanes::less(keys, pivots) : Lanes::less(pivots, keys));
+        else
+            mask = Descending ? Lanes::less(pivots, keys) : Lanes::less(keys, pivots);
+        int selected = __builtin_popcount(mask);
+
+        typename Lanes::Vec packed = Lanes::compress(keys, mask);
+        Lanes::store(write_left, packed);
+        Lanes::store(write_right - WIDTH, packed);
+        write_left += selected;
+        write_right -= WIDTH - selected;
+    }
+
+    size_t rest = read_right - read_left;
+    std::memcpy(remaining + 2 * WIDTH, read_left, rest * sizeof(T));
+    return place_remaining<T, Descending, OrEqual>(write_left, write_right, remaining, 2 * WIDTH + rest, pivot);
+}
+
+template <typename T, bool Descending>
+void network_sort_avx2(T *first, T *last)
+{
+    VectorNetwork<T, 32, Descending>::sort(first, last);
+}
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,popcnt")
+
+// AVX-512 compares straight into mask registers and compress-stores just
+// the lanes of a mask, so no lane order table is needed
+template <typename T>
+struct Avx512Lanes;
+
+template <>
+struct Avx512Lanes<int32_t>
+{
+    using Vec = __m512i;
+    static constexpr int COUNT = 16;
+
+    static Vec load(const int32_t *from) { return _mm512_loadu_si512(from); }
+    static Vec splat(int32_t key) { return _mm512_set1_epi32(key); }
+    static unsigned less(Vec a, Vec b) { return _mm512_cmplt_epi32_mask(a, b); }
+    static void store_lanes(int32_t *to, unsigned mask, Vec keys)
+    {
+        _mm512_mask_compressstoreu_epi32(to, static_cast<__mmask16>(mask), keys);
+    }
+};
+
+template <>
+struct Avx512Lanes<float>
+{
+    using Vec = __m512;
+    static constexpr int COUNT = 16;
+
+    static Vec load(const float *from) { return _mm512_loadu_ps(from); }
+    static Vec splat(float key) { return _mm512_set1_ps(key); }
+    static unsigned less(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static void store_lanes(float *to, unsigned mask, Vec keys)
+    {
+        _mm512_mask_compressstoreu_ps(to, static_cast<__mmask16>(mask), keys);
+    }
+};
+
+template <>
+struct Avx512Lanes<double>
+{
+    using Vec = __m512d;
+    static constexpr int COUNT = 8;
+
+    static Vec load(const double *from) { return _mm512_loadu_pd(from); }
+    static Vec splat(double key) { return _mm512_set1_pd(key); }
+    static unsigned less(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static void store_lanes(double *to, unsigned mask, Vec keys)
+    {
+        _mm512_mask_compressstoreu_pd(to, static_cast<__mmask8>(mask), keys);
+    }
+};
+
+template <>
+struct Avx512Lanes<uint64_t>
+{
+    using Vec = __m512i;
+    static constexpr int COUNT = 8;
+
+    static Vec load(const uint64_t *from) { return _mm512_loadu_si512(from); }
+    static Vec splat(uint64_t key) { return _mm512_set1_epi64(static_cast<long long>(key)); }
+    static unsigned less(Vec a, Vec b) { return _mm512_cmplt_epu64_mask(a, b); }
+    static void store_lanes(uint64_t *to, unsigned mask, Vec keys)
+    {
+        _mm512_mask_compressstoreu_epi64(to, static_cast<__mmask8>(mask), keys);
+    }
+};
+
+// partition_avx512() - partition_avx2() with compress stores, which write
+// exactly the selected keys to the left end and the others to the right
+template <typename T, bool Descending, bool OrEqual>
+T *partition_avx512(T *first, T *last, T pivot)
+{
+    using Lanes = Avx512Lanes<T>;
+    constexpr ptrdiff_t WIDTH = Lanes::COUNT;
+    constexpr unsigned ALL = (1u << WIDTH) - 1;
+    if (last - first < 2 * WIDTH)
+        return partition_scalar<T, Descending, OrEqual>(first, last, pivot);
+
+    T remaining[3 * WIDTH];
+    std::memcpy(remaining, first, WIDTH * sizeof(T));
+    std::memcpy(remaining + WIDTH, last - WIDTH, WIDTH * sizeof(T));
+
+    T *read_left = first + WIDTH;
+    T *read_right = last - WIDTH;
+    T *write_left = first;
+    T *write_right = last;
+    typename Lanes::Vec pivots = Lanes::splat(pivot);
+    while (read_right - read_left >= WIDTH)
+    {
+        typename Lanes::Vec keys;
+        if (read_left - write_left <= write_right - read_right)
+        {
+            keys = Lanes::load(read_left);
+            read_left += WIDTH;
+        }
+        else
+        {
+            read_right -= WIDTH;
+            keys = Lanes::load(read_right);
+        }
+
+        unsigned mask;
+        if constexpr (OrEqual)
+            mask = ALL & ~(Descending ? Lanes::less(keys, pivots) : Lanes::less(pivots, keys));
+        else
+            mask = Descending ? Lanes::less(pivots, keys) : Lanes::less(keys, pivots);
+        int selected = __builtin_popcount(mask);
+
+        Lanes::store_lanes(write_left, mask, keys);
+        write_left += selected;
+        write_right -= WIDTH - selected;
+        Lanes::store_lanes(write_right, ALL & ~mask, keys);
+    }
+
+    size_t rest = read_right - read_left;
+    std::memcpy(remaining + 2 * WIDTH, read_left, rest * sizeof(T));
+    return place_remaining<T, Descending, OrEqual>(write_left, write_right, remaining, 2 * WIDTH + rest, pivot);
+}
+
+template <typename T, bool Descending>
+void network_sort_avx512(T *first, T *last)
+{
+    VectorNetwork<T, 64, Descending>::sort(first, last);
+}
+
+#pragma GCC pop_options
+
+#endif
+
+inline bool simd_sort_supported()
+{
+#if SIMD_PARTITION_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+template <typename T, bool Descending>
+SimdSortKernels<T, Descending> simd_sort_kernels()
+{
+#if SIMD_PARTITION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return {partition_avx512<T, Descending, false>, partition_avx512<T, Descending, true>,
+                network_sort_avx512<T, Descending>, 2 * 64 / sizeof(T)};
+    if (simd_sort_supported())
+        return {partition_avx2<T, Descending, false>, partition_avx2<T, Descending, true>,
+                network_sort_avx2<T, Descending>, 2 * 32 / sizeof(T)};
+#endif
+    return {nullptr, nullptr, nullptr, 0};
+}
+
+#endif
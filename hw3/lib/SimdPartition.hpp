@@ -0,0 +1,71 @@
+#ifndef SIMD_PARTITION_HPP
+#define SIMD_PARTITION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// The vectorized kernels are built with GCC target pragmas and vector
+// extensions, so they exist for x86-64 GCC; elsewhere every range takes the
+// generic path
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define SIMD_PARTITION_X86 1
+#else
+#define SIMD_PARTITION_X86 0
+#endif
+
+// Whether quick_sort may hand [first, last) to the vectorized kernels: a
+// contiguous range of int, float, double or uint64_t keys ordered by
+// std::less or std::greater
+template <typename RandomAccessIter, typename Comparator>
+struct SimdSortable
+{
+    using key_type = typename std::iterator_traits<RandomAccessIter>::value_type;
+
+    static constexpr bool ascending =
+        std::is_same_v<Comparator, std::less<key_type>> || std::is_same_v<Comparator, std::less<>>;
+    static constexpr bool descending =
+        std::is_same_v<Comparator, std::greater<key_type>> || std::is_same_v<Comparator, std::greater<>>;
+    static constexpr bool contiguous =
+        std::is_same_v<RandomAccessIter, key_type *> ||
+        std::is_same_v<RandomAccessIter, typename std::vector<key_type>::iterator>;
+    static constexpr bool arithmetic = std::is_same_v<key_type, int32_t> || std::is_same_v<key_type, float> ||
+                                       std::is_same_v<key_type, double> || std::is_same_v<key_type, uint64_t>;
+
+    static constexpr bool value = SIMD_PARTITION_X86 && contiguous && arithmetic && (ascending || descending);
+};
+
+// Partition kernel: moves the keys of [first, last) it selects relative to
+// pivot in front of the others and returns where they end
+template <typename T>
+using SimdPartitionFn = T *(*)(T *first, T *last, T pivot);
+
+// Small sort kernel: sorts [first, last), which holds at most small_sort_max keys
+template <typename T>
+using SimdSmallSortFn = void (*)(T *first, T *last);
+
+// Kernels for keys sorted ascending, or descending when Descending is set
+template <typename T, bool Descending>
+struct SimdSortKernels
+{
+    // Selects keys ordered before the pivot
+    SimdPartitionFn<T> before;
+    // Selects keys not ordered after the pivot, i.e. also those equal to it
+    SimdPartitionFn<T> not_after;
+    // Sorting network over two vector registers of keys
+    SimdSmallSortFn<T> small_sort;
+    ptrdiff_t small_sort_max;
+};
+
+// simd_sort_supported() - Whether the running CPU has the kernels at all
+bool simd_sort_supported();
+
+// simd_sort_kernels() - The widest kernels the running CPU supports
+// (AVX-512, then AVX2); all members are null when it has neither
+template <typename T, bool Descending>
+SimdSortKernels<T, Descending> simd_sort_kernels();
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef THREAD_POOL_CPP
+#define THREAD_POOL_CPP
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+// Which pool and worker slot the calling thread belongs to, if any
+inline thread_local const WorkStealingPool *current_pool = nullptr;
+inline thread_local size_t current_worker_index = 0;
+
+inline WorkStealingPool::WorkStealingPool(size_t threads) : _queued(0), _next_queue(0), _stop(false)
+{
+    if (threads == 0)
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < threads; i++)
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    for (size_t i = 0; i < threads; i++)
+        _workers.emplace_back([this, i]()
+                              { worker_loop(i); });
+}
+
+inline WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (std::thread &worker : _workers)
+        worker.join();
+}
+
+inline size_t WorkStealingPool::size() const
+{
+    return _workers.size();
+}
+
+// current_worker() - Index of the calling worker, or size() for threads outside the pool
+inline size_t WorkStealingPool::current_worker() const
+{
+    return current_pool == this ? current_worker_index : _workers.size();
+}
+
+inline void WorkStealingPool::submit(std::function<void()> task)
+{
+    size_t worker = current_worker();
+    if (worker == _workers.size())
+        worker = _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(_queues[worker]->mutex);
+        _queues[worker]->tasks.push_back(std::move(task));
+    }
+    _queued.fetch_add(1);
+
+    // Passing through the sleep mutex orders this push before any sleeper's
+    // re-check, so the notification cannot be lost
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+    }
+    _wake.notify_one();
+}
+
+inline bool WorkStealingPool::pop_own(size_t worker, std::function<void()> &task)
+{
+    WorkerQueue &queue = *_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+// steal() - Takes the oldest task of the first non-empty deque, starting after the thief's own
+inline bool WorkStealingPool::steal(size_t thief, std::function<void()> &task)
+{
+    for (size_t offset = 1; offset <= _queues.size(); offset++)
+    {
+        WorkerQueue &queue = *_queues[(thief + offset) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool WorkStealingPool::run_one()
+{
+    if (_queued.load() == 0)
+        return false;
+
+    size_t worker = current_worker();
+    std::function<void()> task;
+    bool found = worker < _queues.size() ? pop_own(worker, task) || steal(worker, task) : steal(0, task);
+    if (!found)
+        return false;
+
+    _queued.fetch_sub(1);
+    task();
+    return true;
+}
+
+inline void WorkStealingPool::worker_loop(size_t worker)
+{
+    current_pool = this;
+    current_worker_index = worker;
+
+    while (true)
+    {
+        if (run_one())
+            continue;
+
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _wake.wait(lock, [this]()
+                   { return _stop || _queued.load() > 0; });
+        if (_stop && _queued.load() == 0)
+            return;
+    }
+}
+
+inline TaskGroup::TaskGroup(WorkStealingPool &pool) : _pool(pool), _pending(0) {}
+
+// Destructor - Never leaves tasks running that refer to this group
+inline TaskGroup::~TaskGroup()
+{
+    while (_pending.load() > 0)
+    {
+        if (!_pool.run_one())
+            std::this_thread::yield();
+    }
+}
+
+template <typename Task>
+void TaskGroup::run(Task task)
+{
+    _pending.fetch_add(1);
+    _pool.submit([this, task = std::move(task)]() mutable
+                 {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_error_mutex);
+            if (!_error)
+                _error = std::current_exception();
+        }
+        _pending.fetch_sub(1); });
+}
+
+inline void TaskGroup::wait()
+{
+    while (_pending.load() > 0)
+    {
+        if (!_pool.run_one())
+            std::this_thread::yield();
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(_error_mutex);
+        error = std::exchange(_error, nullptr);
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+#endif
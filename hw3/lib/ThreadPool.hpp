@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. A worker pushes and
+// pops its own tasks at the back (newest first, which keeps a fork-join
+// recursion depth-first and cache-warm) and, when it runs dry, steals the
+// oldest task from the front of another worker's deque, which for a
+// divide-and-conquer algorithm is the largest piece of outstanding work.
+// Tasks submitted from outside the pool are dealt round-robin.
+class WorkStealingPool
+{
+private:
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+    std::atomic<size_t> _queued;
+    std::atomic<size_t> _next_queue;
+    std::atomic<bool> _stop;
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+
+    size_t current_worker() const;
+    bool pop_own(size_t worker, std::function<void()> &task);
+    bool steal(size_t thief, std::function<void()> &task);
+    void worker_loop(size_t worker);
+
+public:
+    // Constructor - Starts threads workers; 0 means one per hardware thread
+    explicit WorkStealingPool(size_t threads = 0);
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+    ~WorkStealingPool();
+
+    size_t size() const;
+
+    // submit() - Queues task on the calling worker's deque, or on any deque from outside the pool
+    void submit(std::function<void()> task);
+    // run_one() - Runs one queued task on the calling thread; false if none was found
+    bool run_one();
+};
+
+// Fork-join scope on a pool. wait() runs queued tasks while it waits, so
+// tasks may fork and wait on their own groups without tying up workers,
+// and rethrows the first exception any task of the group threw.
+class TaskGroup
+{
+private:
+    WorkStealingPool &_pool;
+    std::atomic<size_t> _pending;
+    std::mutex _error_mutex;
+    std::exception_ptr _error;
+
+public:
+    explicit TaskGroup(WorkStealingPool &pool);
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+    ~TaskGroup();
+
+    template <typename Task>
+    void run(Task task);
+    void wait();
+};
+
+#endif
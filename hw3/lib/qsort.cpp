@@ -2,39 +2,653 @@
 #define QSORT_CPP
 
 #include "qsort.hpp"
+#include "SimdPartition.cpp"
+#include "ThreadPool.cpp"
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
-#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
 using namespace std;
 
+// A partition leaving less than 1/UNBALANCED_FRACTION of the range on one side counts as bad
+const ptrdiff_t UNBALANCED_FRACTION = 8;
+
+inline SortRandom::SortRandom(uint64_t seed)
+{
+    // splitmix64 spreads any seed, including 0, over the whole state
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    _state = z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+inline uint64_t SortRandom::next()
+{
+    _state ^= _state >> 12;
+    _state ^= _state << 25;
+    _state ^= _state >> 27;
+    return _state * 0x2545F4914F6CDD1DULL;
+}
+
+// below() - Lemire's multiply-shift; the rare biased low products are redrawn
+inline uint64_t SortRandom::below(uint64_t bound)
+{
+    unsigned __int128 product = static_cast<unsigned __int128>(next()) * bound;
+    uint64_t low = static_cast<uint64_t>(product);
+    if (low < bound)
+    {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold)
+        {
+            product = static_cast<unsigned __int128>(next()) * bound;
+            low = static_cast<uint64_t>(product);
+        }
+    }
+    return static_cast<uint64_t>(product >> 64);
+}
+
+// sort_random() - The calling thread's generator
+inline SortRandom &sort_random()
+{
+    thread_local SortRandom generator(0);
+    return generator;
+}
+
+inline void seed_quick_sort(uint64_t seed)
+{
+    sort_random() = SortRandom(seed);
+}
+
+// Ranges at or below this size are finished by insertion sort
+const ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+// Ranges above this size take the pivot as a ninther instead of a median of three
+const ptrdiff_t NINTHER_THRESHOLD = 128;
+
+// insertion_sort() - Sorts a short range; fast on nearly sorted input
 template <typename RandomAccessIter, typename Comparator>
-void quick_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+void insertion_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
 {
-    // Sorting the range
-    if (first == last || distance(first, last) <= 1)
+    if (first == last)
         return;
 
-    // Randomized pivot selection using rand()
-    RandomAccessIter pivot_iter = first + (rand() % distance(first, last));
+    for (RandomAccessIter i = next(first); i != last; ++i)
+    {
+        auto value = std::move(*i);
+        if (comparator(value, *first))
+        {
+            // New minimum: shift the whole prefix
+            move_backward(first, i, next(i));
+            *first = std::move(value);
+        }
+        else
+        {
+            // *first is not above value, so the scan stops without a bounds check
+            RandomAccessIter hole = i;
+            for (RandomAccessIter before = prev(i); comparator(value, *before); --before)
+            {
+                *hole = std::move(*before);
+                hole = before;
+            }
+            *hole = std::move(value);
+        }
+    }
+}
+
+// heap_sort() - O(n log n) worst-case fallback once quicksort recursion runs too deep
+template <typename RandomAccessIter, typename Comparator>
+void heap_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    make_heap(first, last, comparator);
+    sort_heap(first, last, comparator);
+}
 
-    iter_swap(pivot_iter, prev(last)); // Move the pivot to the last position
+// median_of_three() - Returns whichever of a, b, c holds the median value
+template <typename RandomAccessIter, typename Comparator>
+RandomAccessIter median_of_three(RandomAccessIter a, RandomAccessIter b, RandomAccessIter c, Comparator comparator)
+{
+    if (comparator(*a, *b))
+    {
+        if (comparator(*b, *c))
+            return b;
+        return comparator(*a, *c) ? c : a;
+    }
+    if (comparator(*a, *c))
+        return a;
+    return comparator(*b, *c) ? c : b;
+}
 
-    auto pivot = *prev(last);
-    RandomAccessIter i = first;
+// choose_pivot() - Moves a median of three (or, for large ranges, Tukey's
+// ninther: the median of three medians of three) to *first. The other
+// samples stay in the range, so some element not below the pivot and some
+// not above it remain on either side of it.
+template <typename RandomAccessIter, typename Comparator>
+void choose_pivot(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    ptrdiff_t length = distance(first, last);
+    RandomAccessIter middle = first + length / 2;
+    RandomAccessIter pivot;
+
+    if (length > NINTHER_THRESHOLD)
+    {
+        ptrdiff_t step = length / 8;
+        RandomAccessIter low = median_of_three(first + 1, first + 1 + step, first + 1 + 2 * step, comparator);
+        RandomAccessIter mid = median_of_three(middle - step, middle, middle + step, comparator);
+        RandomAccessIter high = median_of_three(last - 1 - 2 * step, last - 1 - step, last - 1, comparator);
+        pivot = median_of_three(low, mid, high, comparator);
+    }
+    else
+    {
+        pivot = median_of_three(first + 1, middle, last - 1, comparator);
+    }
+    iter_swap(first, pivot);
+}
 
-    for (RandomAccessIter j = first; j != prev(last); ++j)
+// partition_at_pivot() - Hoare partition of (first, last) around *first.
+// Both scans stop on elements equal to the pivot, so runs of duplicates are
+// split evenly instead of degrading to O(n^2). Returns cut, with
+// [first, cut) not above the pivot, [cut, last) not below it, and both non-empty.
+template <typename RandomAccessIter, typename Comparator>
+RandomAccessIter partition_at_pivot(RandomAccessIter first, RandomAccessIter last, Comparator comparator)
+{
+    RandomAccessIter left = next(first);
+    RandomAccessIter right = last;
+    while (true)
     {
-        if (comparator(*j, pivot)) // Comparator determines order
+        while (comparator(*left, *first))
+            ++left;
+        --right;
+        while (comparator(*first, *right))
+            --right;
+        if (!(left < right))
+            return left;
+        iter_swap(left, right);
+        ++left;
+    }
+}
+
+// partition_three_way() - Dijkstra's Dutch national flag partition around
+// *first. Returns (lt, gt) with [first, lt) below the pivot, [lt, gt) equal
+// to it and [gt, last) above it; the middle is never empty.
+template <typename RandomAccessIter, typename Comparator>
+pair<RandomAccessIter, RandomAccessIter> partition_three_way(RandomAccessIter first, RandomAccessIter last,
+                                                             Comparator comparator)
+{
+    // *lt is always the first element equal to the pivot
+    RandomAccessIter lt = first;
+    RandomAccessIter i = next(first);
+    RandomAccessIter gt = last;
+    while (i < gt)
+    {
+        if (comparator(*i, *lt))
         {
-            iter_swap(i, j);
+            iter_swap(lt, i);
+            ++lt;
             ++i;
         }
+        else if (comparator(*lt, *i))
+        {
+            --gt;
+            iter_swap(i, gt);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return {lt, gt};
+}
+
+// Elements scanned per block by partition_blocks(); offsets fit in a byte
+const ptrdiff_t PARTITION_BLOCK = 64;
+
+// partition_blocks() - Block partition (Edelkamp and Weiss): moves the
+// elements of [first, last) satisfying predicate in front of the others and
+// returns the split. Each side scans a block, recording the offsets of its
+// misplaced elements without branching on the outcome, then as many pairs
+// as both sides have are swapped. The final blocks shrink to cover what is
+// left, and leftover misplaced elements of the last block are moved to the
+// split one by one.
+template <typename RandomAccessIter, typename Predicate>
+RandomAccessIter partition_blocks(RandomAccessIter first, RandomAccessIter last, Predicate predicate)
+{
+    unsigned char left_offsets[PARTITION_BLOCK];
+    unsigned char right_offsets[PARTITION_BLOCK];
+    ptrdiff_t left_count = 0;
+    ptrdiff_t right_count = 0;
+    ptrdiff_t left_start = 0;
+    ptrdiff_t right_start = 0;
+    ptrdiff_t left_size = PARTITION_BLOCK;
+    ptrdiff_t right_size = PARTITION_BLOCK;
+
+    // [first, last) holds the unknown elements, including the block a side
+    // still has misplaced elements in
+    while (true)
+    {
+        bool final_round = last - first <= 2 * PARTITION_BLOCK;
+        if (final_round)
+        {
+            ptrdiff_t unscanned = (last - first) - (left_count != 0 || right_count != 0 ? PARTITION_BLOCK : 0);
+            if (left_count != 0)
+            {
+                right_size = unscanned;
+            }
+            else if (right_count != 0)
+            {
+                left_size = unscanned;
+            }
+            else
+            {
+                left_size = unscanned / 2;
+                right_size = unscanned - left_size;
+            }
+        }
+
+        if (left_count == 0)
+        {
+            left_start = 0;
+            for (ptrdiff_t i = 0; i < left_size; i++)
+            {
+                left_offsets[left_count] = static_cast<unsigned char>(i);
+                left_count += !predicate(first[i]);
+            }
+        }
+        if (right_count == 0)
+        {
+            right_start = 0;
+            for (ptrdiff_t i = 1; i <= right_size; i++)
+            {
+                right_offsets[right_count] = static_cast<unsigned char>(i);
+                right_count += predicate(*(last - i));
+            }
+        }
+
+        ptrdiff_t swaps = min(left_count, right_count);
+        for (ptrdiff_t k = 0; k < swaps; k++)
+            iter_swap(first + left_offsets[left_start + k], last - right_offsets[right_start + k]);
+        left_count -= swaps;
+        right_count -= swaps;
+        left_start += swaps;
+        right_start += swaps;
+        if (left_count == 0)
+            first += left_size;
+        if (right_count == 0)
+            last -= right_size;
+
+        if (final_round)
+            break;
+    }
+
+    // At most one block is left, and [first, last) is exactly that block;
+    // its misplaced elements go to its far end, furthest from it first
+    if (left_count > 0)
+    {
+        while (left_count > 0)
+        {
+            left_count--;
+            iter_swap(first + left_offsets[left_start + left_count], --last);
+        }
+        return last;
+    }
+    while (right_count > 0)
+    {
+        right_count--;
+        iter_swap(last - right_offsets[right_start + right_count], first);
+        ++first;
+    }
+    return first;
+}
+
+// split_at_pivot() - Partitions (first, last) around the pivot at *first
+// with partition(begin, end, predicate), then moves the pivot between the
+// two sides so that it is excluded from both. Keys equal to the pivot all
+// land on the right; when gather_equal is set or the left side comes out
+// short, a second pass moves them next to the pivot so they are not
+// partitioned again. Returns (left_end, right_begin), the ends of the
+// ranges still to sort.
+template <typename RandomAccessIter, typename Comparator, typename Partition>
+pair<RandomAccessIter, RandomAccessIter> split_at_pivot(RandomAccessIter first, RandomAccessIter last,
+                                                        Comparator comparator, bool gather_equal,
+                                                        Partition partition)
+{
+    RandomAccessIter split = partition(next(first), last, [&comparator, first](const auto &value)
+                                       { return comparator(value, *first); });
+    RandomAccessIter left_end = prev(split);
+    iter_swap(first, left_end);
+
+    RandomAccessIter right_begin = split;
+    if (gather_equal || distance(first, left_end) < distance(first, last) / UNBALANCED_FRACTION)
+    {
+        right_begin = partition(split, last, [&comparator, left_end](const auto &value)
+                                { return !comparator(*left_end, value); });
+    }
+    return {left_end, right_begin};
+}
+
+// break_patterns() - Swaps random elements into the positions choose_pivot()
+// samples, so the input pattern that just produced a bad pivot is unlikely
+// to produce another
+template <typename RandomAccessIter>
+void break_patterns(RandomAccessIter first, RandomAccessIter last)
+{
+    ptrdiff_t length = distance(first, last);
+    if (length <= INSERTION_SORT_THRESHOLD)
+        return;
+
+    SortRandom &random = sort_random();
+    RandomAccessIter samples[] = {first + 1, first + length / 4, first + length / 2, last - length / 4, last - 1};
+    for (RandomAccessIter sample : samples)
+        iter_swap(sample, first + static_cast<ptrdiff_t>(random.below(static_cast<uint64_t>(length))));
+}
+
+// introsort_loop() - Partitions until ranges are small, recursing into the
+// smaller side and looping on the larger; depth_limit counts partitions left
+// before switching to heapsort
+template <typename RandomAccessIter, typename Comparator>
+void introsort_loop(RandomAccessIter first, RandomAccessIter last, int depth_limit, Comparator comparator,
+                    PartitionScheme scheme)
+{
+    while (distance(first, last) > INSERTION_SORT_THRESHOLD)
+    {
+        if (depth_limit == 0)
+        {
+            heap_sort(first, last, comparator);
+            return;
+        }
+        depth_limit--;
+
+        choose_pivot(first, last, comparator);
+
+        // Still to sort: [first, left_end) and [right_begin, last)
+        RandomAccessIter left_end;
+        RandomAccessIter right_begin;
+        if (scheme == PartitionScheme::ThreeWay)
+        {
+            tie(left_end, right_begin) = partition_three_way(first, last, comparator);
+        }
+        else if (scheme == PartitionScheme::Block)
+        {
+            auto blocks = [](auto begin, auto end, auto predicate)
+            { return partition_blocks(begin, end, predicate); };
+            tie(left_end, right_begin) = split_at_pivot(first, last, comparator, false, blocks);
+        }
+        else
+        {
+            left_end = right_begin = partition_at_pivot(first, last, comparator);
+        }
+
+        ptrdiff_t left_size = distance(first, left_end);
+        ptrdiff_t right_size = distance(right_begin, last);
+        ptrdiff_t length = distance(first, last);
+        if (left_size < length / UNBALANCED_FRACTION || right_size < length / UNBALANCED_FRACTION)
+        {
+            break_patterns(first, left_end);
+            break_patterns(right_begin, last);
+        }
+
+        if (left_size < right_size)
+        {
+            introsort_loop(first, left_end, depth_limit, comparator, scheme);
+            first = right_begin;
+        }
+        else
+        {
+            introsort_loop(right_begin, last, depth_limit, comparator, scheme);
+            last = left_end;
+        }
+    }
+    insertion_sort(first, last, comparator);
+}
+
+// simd_introsort_loop() - introsort_loop() over raw keys, partitioned by
+// vectorized kernels. A kernel pass moves the keys before the pivot to the
+// front and the pivot right behind them; a second pass gathers the keys
+// equal to the pivot when the scheme is ThreeWay or the first pass came out
+// lopsided, so duplicates cannot drive it quadratic. Ranges that fit two
+// vector registers are finished by a sorting network.
+template <typename T, bool Descending, typename Comparator>
+void simd_introsort_loop(T *first, T *last, int depth_limit, Comparator comparator, PartitionScheme scheme,
+                         const SimdSortKernels<T, Descending> &kernels)
+{
+    while (last - first > kernels.small_sort_max)
+    {
+        if (depth_limit == 0)
+        {
+            heap_sort(first, last, comparator);
+            return;
+        }
+        depth_limit--;
+
+        choose_pivot(first, last, comparator);
+        T pivot = *first;
+        T *split = kernels.before(first + 1, last, pivot);
+        swap(*first, split[-1]);
+
+        ptrdiff_t length = last - first;
+        T *left_end = split - 1;
+        T *right_begin = split;
+        if (scheme == PartitionScheme::ThreeWay || left_end - first < length / UNBALANCED_FRACTION)
+            right_begin = kernels.not_after(right_begin, last, pivot);
+
+        ptrdiff_t left_size = left_end - first;
+        ptrdiff_t right_size = last - right_begin;
+        if (left_size < length / UNBALANCED_FRACTION || right_size < length / UNBALANCED_FRACTION)
+        {
+            break_patterns(first, left_end);
+            break_patterns(right_begin, last);
+        }
+
+        if (left_size < right_size)
+        {
+            simd_introsort_loop(first, left_end, depth_limit, comparator, scheme, kernels);
+            first = right_begin;
+        }
+        else
+        {
+            simd_introsort_loop(right_begin, last, depth_limit, comparator, scheme, kernels);
+            last = left_end;
+        }
     }
-    iter_swap(i, prev(last)); // Place the pivot in its correct position
+    kernels.small_sort(first, last);
+}
+
+// sort_loop() - Sorts with the vectorized kernels when the keys, comparator
+// and CPU allow it, with introsort_loop() otherwise
+template <typename RandomAccessIter, typename Comparator>
+void sort_loop(RandomAccessIter first, RandomAccessIter last, int depth_limit, Comparator comparator,
+               PartitionScheme scheme)
+{
+    using Simd = SimdSortable<RandomAccessIter, Comparator>;
+    if constexpr (Simd::value)
+    {
+        using T = typename Simd::key_type;
+        static const SimdSortKernels<T, Simd::descending> kernels = simd_sort_kernels<T, Simd::descending>();
+        if (kernels.before != nullptr && first != last)
+        {
+            T *begin = &*first;
+            simd_introsort_loop(begin, begin + distance(first, last), depth_limit, comparator, scheme, kernels);
+            return;
+        }
+    }
+    introsort_loop(first, last, depth_limit, comparator, scheme);
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void quick_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator, PartitionScheme scheme)
+{
+    ptrdiff_t length = distance(first, last);
+    if (length <= 1)
+        return;
+
+    // 2 * floor(log2(length))
+    int depth_limit = 0;
+    for (ptrdiff_t n = length; n > 1; n >>= 1)
+        depth_limit += 2;
+
+    sort_loop(first, last, depth_limit, comparator, scheme);
+}
+
+// Ranges above this size are split into parallel tasks; smaller ones are not worth a task
+const ptrdiff_t PARALLEL_GRAIN = 1 << 14;
+// Ranges at or above this size are also partitioned in parallel
+const ptrdiff_t PARALLEL_PARTITION_THRESHOLD = 1 << 20;
+
+// parallel_partition() - Moves the elements of [first, last) satisfying
+// predicate in front of the others and returns the split point. Blocks are
+// partitioned independently, then the elements left on the wrong side of
+// the overall split are swapped across it in parallel chunks.
+template <typename RandomAccessIter, typename Predicate>
+RandomAccessIter parallel_partition(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last,
+                                    Predicate predicate)
+{
+    ptrdiff_t length = distance(first, last);
+    ptrdiff_t blocks = min(static_cast<ptrdiff_t>(pool.size() * 4), max<ptrdiff_t>(1, length / PARALLEL_GRAIN));
+
+    vector<RandomAccessIter> bounds(blocks + 1);
+    vector<RandomAccessIter> splits(blocks);
+    for (ptrdiff_t i = 0; i <= blocks; i++)
+        bounds[i] = first + length * i / blocks;
+
+    TaskGroup partition_group(pool);
+    for (ptrdiff_t i = 0; i < blocks; i++)
+        partition_group.run([&, i]()
+                            { splits[i] = partition(bounds[i], bounds[i + 1], predicate); });
+    partition_group.wait();
+
+    ptrdiff_t selected = 0;
+    for (ptrdiff_t i = 0; i < blocks; i++)
+        selected += distance(bounds[i], splits[i]);
+    RandomAccessIter split = first + selected;
+
+    // Rejected elements before split and selected ones after it, as intervals;
+    // both add up to the same count
+    vector<pair<RandomAccessIter, RandomAccessIter>> rejected;
+    vector<pair<RandomAccessIter, RandomAccessIter>> misplaced;
+    for (ptrdiff_t i = 0; i < blocks; i++)
+    {
+        if (splits[i] < split && splits[i] < bounds[i + 1])
+            rejected.emplace_back(splits[i], min(bounds[i + 1], split));
+        if (split < splits[i] && bounds[i] < splits[i])
+            misplaced.emplace_back(max(bounds[i], split), splits[i]);
+    }
+
+    // offsets[k] - Number of elements in the intervals before interval k
+    auto offsets_of = [](const vector<pair<RandomAccessIter, RandomAccessIter>> &intervals)
+    {
+        vector<ptrdiff_t> offsets(1, 0);
+        for (const auto &interval : intervals)
+            offsets.push_back(offsets.back() + distance(interval.first, interval.second));
+        return offsets;
+    };
+    vector<ptrdiff_t> rejected_offsets = offsets_of(rejected);
+    vector<ptrdiff_t> misplaced_offsets = offsets_of(misplaced);
+    ptrdiff_t total = rejected_offsets.back();
+
+    // at() - Position of the index-th element across intervals
+    auto at = [](const vector<pair<RandomAccessIter, RandomAccessIter>> &intervals, const vector<ptrdiff_t> &offsets,
+                 ptrdiff_t index)
+    {
+        size_t k = upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin() - 1;
+        return intervals[k].first + (index - offsets[k]);
+    };
+
+    TaskGroup swap_group(pool);
+    for (ptrdiff_t begin = 0; begin < total; begin += PARALLEL_GRAIN)
+    {
+        ptrdiff_t end = min(total, begin + PARALLEL_GRAIN);
+        swap_group.run([&, begin, end]()
+                       {
+            for (ptrdiff_t index = begin; index < end; index++)
+                iter_swap(at(rejected, rejected_offsets, index), at(misplaced, misplaced_offsets, index)); });
+    }
+    swap_group.wait();
+
+    return split;
+}
+
+// parallel_sort_loop() - introsort_loop() that forks the smaller side of
+// each partition as a task and keeps the larger one, down to PARALLEL_GRAIN
+template <typename RandomAccessIter, typename Comparator>
+void parallel_sort_loop(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last, int depth_limit,
+                        Comparator comparator, PartitionScheme scheme)
+{
+    TaskGroup group(pool);
+    while (distance(first, last) > PARALLEL_GRAIN)
+    {
+        if (depth_limit == 0)
+        {
+            heap_sort(first, last, comparator);
+            group.wait();
+            return;
+        }
+        depth_limit--;
+
+        choose_pivot(first, last, comparator);
+        ptrdiff_t length = distance(first, last);
+
+        RandomAccessIter left_end;
+        RandomAccessIter right_begin;
+        if (length >= PARALLEL_PARTITION_THRESHOLD)
+        {
+            tie(left_end, right_begin) = split_at_pivot(first, last, comparator, scheme == PartitionScheme::ThreeWay,
+                                                        [&pool](auto begin, auto end, auto predicate)
+                                                        { return parallel_partition(pool, begin, end, predicate); });
+        }
+        else if (scheme == PartitionScheme::ThreeWay)
+        {
+            tie(left_end, right_begin) = partition_three_way(first, last, comparator);
+        }
+        else if (scheme == PartitionScheme::Block)
+        {
+            auto blocks = [](auto begin, auto end, auto predicate)
+            { return partition_blocks(begin, end, predicate); };
+            tie(left_end, right_begin) = split_at_pivot(first, last, comparator, false, blocks);
+        }
+        else
+        {
+            left_end = right_begin = partition_at_pivot(first, last, comparator);
+        }
+
+        ptrdiff_t left_size = distance(first, left_end);
+        ptrdiff_t right_size = distance(right_begin, last);
+        if (left_size < length / UNBALANCED_FRACTION || right_size < length / UNBALANCED_FRACTION)
+        {
+            break_patterns(first, left_end);
+            break_patterns(right_begin, last);
+        }
+
+        if (left_size < right_size)
+        {
+            group.run([&pool, first, left_end, depth_limit, comparator, scheme]()
+                      { parallel_sort_loop(pool, first, left_end, depth_limit, comparator, scheme); });
+            first = right_begin;
+        }
+        else
+        {
+            group.run([&pool, right_begin, last, depth_limit, comparator, scheme]()
+                      { parallel_sort_loop(pool, right_begin, last, depth_limit, comparator, scheme); });
+            last = left_end;
+        }
+    }
+    sort_loop(first, last, depth_limit, comparator, scheme);
+    group.wait();
+}
+
+template <typename RandomAccessIter, typename Comparator>
+void quick_sort(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last, Comparator comparator,
+                PartitionScheme scheme)
+{
+    ptrdiff_t length = distance(first, last);
+    if (length <= 1)
+        return;
+
+    int depth_limit = 0;
+    for (ptrdiff_t n = length; n > 1; n >>= 1)
+        depth_limit += 2;
 
-    // Recursive sorting of subranges
-    quick_sort(first, i, comparator);
-    quick_sort(next(i), last, comparator);
+    parallel_sort_loop(pool, first, last, depth_limit, comparator, scheme);
 }
 
 #endif
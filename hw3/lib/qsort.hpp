@@ -0,0 +1,70 @@
+#ifndef QSORT_HPP
+#define QSORT_HPP
+
+#include "ThreadPool.hpp"
+#include <cstdint>
+
+// How quick_sort splits a range around its pivot
+enum class PartitionScheme
+{
+    // Two-way Hoare partition; keys equal to the pivot are spread over both sides
+    Hoare,
+    // Dutch national flag partition; keys equal to the pivot are set aside and
+    // never looked at again, so inputs with few distinct keys sort in close
+    // to linear time
+    ThreeWay,
+    // BlockQuicksort: comparison outcomes for a block of elements are first
+    // recorded as offsets, then the misplaced elements are swapped, so the
+    // outcome of a comparison never decides a branch. Pays off when
+    // comparisons are cheap but unpredictable, as on random input.
+    Block,
+};
+
+// Small, fast PRNG (xorshift64*, seeded through splitmix64) that quick_sort
+// uses to break up input patterns. Every thread has its own generator, so
+// concurrent sorts share no state and take no locks.
+class SortRandom
+{
+private:
+    uint64_t _state;
+
+public:
+    explicit SortRandom(uint64_t seed);
+
+    uint64_t next();
+    // below() - Uniform value in [0, bound) without modulo bias; bound must be positive
+    uint64_t below(uint64_t bound);
+};
+
+// seed_quick_sort() - Reseeds the calling thread's generator so that its
+// following sorts take the same steps on every run
+void seed_quick_sort(uint64_t seed);
+
+// quick_sort() - Sorts [first, last) by comparator. Introsort: quicksort
+// with ninther pivots that recurses only into the smaller side, hands
+// small ranges to insertion sort and falls back to heapsort once the
+// recursion gets deeper than 2 log n, so the worst case is O(n log n) time
+// and O(log n) stack. A badly unbalanced partition also moves random
+// elements into the pivot sample positions, breaking up the pattern that
+// caused it. Not stable.
+//
+// Contiguous ranges of int, float, double or uint64_t sorted by std::less
+// or std::greater are partitioned with AVX-512 or AVX2 compress kernels,
+// picked at run time, and finished with sorting networks; on other CPUs
+// they take the generic path.
+template <typename RandomAccessIter, typename Comparator>
+void quick_sort(RandomAccessIter first, RandomAccessIter last, Comparator comparator,
+                PartitionScheme scheme = PartitionScheme::Hoare);
+
+// quick_sort() - Parallel version on pool. Both sides of every partition
+// above a grain size are sorted as separate fork-join tasks, and very large
+// ranges are also partitioned in parallel blocks, so a sort of n elements
+// keeps every worker busy from the first partition on. Below the grain size
+// the sequential introsort takes over; the depth limit and heapsort
+// fallback apply as before. The calling thread helps run tasks until the
+// sort is done, and an exception thrown by comparator is rethrown here.
+template <typename RandomAccessIter, typename Comparator>
+void quick_sort(WorkStealingPool &pool, RandomAccessIter first, RandomAccessIter last, Comparator comparator,
+                PartitionScheme scheme = PartitionScheme::Hoare);
+
+#endif
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "ExternalSort.cpp"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+
+static std::string test_path(const std::string &name)
+{
+    return testing::TempDir() + name;
+}
+
+// A fresh directory for run files, so a test can check that none are left behind
+static std::string run_directory(const std::string &name)
+{
+    std::string directory = test_path(name);
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+template <typename T>
+static void write_records(const std::string &path, const std::vector<T> &records)
+{
+    RecordWriter<T> writer(path, 4096);
+    for (const T &record : records)
+        writer.write(record);
+    writer.close();
+}
+
+template <typename T>
+static std::vector<T> read_records(const std::string &path)
+{
+    RecordReader<T> reader(path, 4096);
+    std::vector<T> records;
+    T record{};
+    while (reader.next(record))
+        records.push_back(record);
+    return records;
+}
+
+// Timestamped events compared by time only, tagged with their input position
+struct Event
+{
+    uint32_t time;
+    uint32_t sequence;
+};
+
+static bool event_less(const Event &a, const Event &b)
+{
+    return a.time < b.time;
+}
+
+TEST(ExternalSortTest, SortsAFileManyTimesTheBudget)
+{
+    // 1.6 MB of records through a 64 KiB budget: the 56 KiB left after the
+    // I/O buffers holds 3584 records and their sort buffer, so 56 runs, more
+    // than one merge can take, and the runs are merged in two passes
+    std::mt19937_64 rng(25);
+    std::vector<uint64_t> values(200000);
+    for (uint64_t &value : values)
+        value = rng();
+    std::string input = test_path("external_uint64.in");
+    std::string output = test_path("external_uint64.out");
+    std::string directory = run_directory("external_uint64_runs");
+    write_records(input, values);
+
+    ExternalSortOptions options;
+    options.memory_budget = 64 << 10;
+    options.io_buffer_bytes = 4 << 10;
+    options.temp_directory = directory;
+    WorkStealingPool pool(2);
+    ExternalSortStats stats = external_sort<uint64_t>(pool, input, output, std::less<uint64_t>(), options);
+
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ(read_records<uint64_t>(output), values);
+    EXPECT_EQ(stats.records, values.size());
+    EXPECT_EQ(stats.runs, 56u);
+    EXPECT_EQ(stats.merge_passes, 2u);
+    EXPECT_TRUE(std::filesystem::is_empty(directory));
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST(ExternalSortTest, KeepsEqualRecordsInInputOrder)
+{
+    std::mt19937 rng(25);
+    std::vector<Event> events(100000);
+    for (uint32_t i = 0; i < events.size(); i++)
+        events[i] = {static_cast<uint32_t>(rng() % 50), i};
+    std::string input = test_path("external_events.in");
+    std::string output = test_path("external_events.out");
+    write_records(input, events);
+
+    ExternalSortOptions options;
+    options.memory_budget = 32 << 10;
+    options.io_buffer_bytes = 2 << 10;
+    options.temp_directory = run_directory("external_events_runs");
+    WorkStealingPool pool(2);
+    ExternalSortStats stats = external_sort<Event>(pool, input, output, event_less, options);
+
+    std::stable_sort(events.begin(), events.end(), event_less);
+    std::vector<Event> sorted = read_records<Event>(output);
+    ASSERT_EQ(sorted.size(), events.size());
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        ASSERT_EQ(sorted[i].time, events[i].time);
+        ASSERT_EQ(sorted[i].sequence, events[i].sequence);
+    }
+    EXPECT_GT(stats.merge_passes, 1u);
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST(ExternalSortTest, SortsLogLines)
+{
+    std::mt19937 rng(25);
+    std::vector<std::string> lines;
+    for (int i = 0; i < 20000; i++)
+        lines.push_back("2026-10-" + std::to_string(10 + rng() % 20) + " " + std::to_string(rng() % 100000) +
+                        " request served");
+    lines.push_back("");
+    lines.push_back("");
+
+    // The last line has no newline
+    std::string input = test_path("external_lines.in");
+    std::string output = test_path("external_lines.out");
+    {
+        std::ofstream out(input, std::ios::binary);
+        for (size_t i = 0; i < lines.size(); i++)
+            out << lines[i] << "\n";
+        out << "2026-10-15 last line";
+    }
+    lines.push_back("2026-10-15 last line");
+
+    ExternalSortOptions options;
+    options.memory_budget = 64 << 10;
+    options.io_buffer_bytes = 1 << 10;
+    options.temp_directory = run_directory("external_lines_runs");
+    WorkStealingPool pool(2);
+    ExternalSortStats stats = external_sort<std::string>(pool, input, output, std::less<std::string>(), options);
+
+    std::sort(lines.begin(), lines.end());
+    ASSERT_EQ(read_records<std::string>(output), lines);
+    EXPECT_EQ(stats.records, lines.size());
+    EXPECT_GT(stats.runs, 1u);
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST(ExternalSortTest, SortsInputThatFitsInPlace)
+{
+    std::vector<int32_t> values{5, -3, 9, 0, -3, 7};
+    std::string path = test_path("external_small");
+    write_records(path, values);
+
+    WorkStealingPool pool(2);
+    ExternalSortStats stats = external_sort<int32_t>(pool, path, path, std::greater<int32_t>());
+    std::sort(values.begin(), values.end(), std::greater<int32_t>());
+    ASSERT_EQ(read_records<int32_t>(path), values);
+    EXPECT_EQ(stats.runs, 1u);
+    EXPECT_EQ(stats.merge_passes, 0u);
+
+    write_records(path, std::vector<int32_t>());
+    stats = external_sort<int32_t>(pool, path, path, std::less<int32_t>());
+    EXPECT_TRUE(read_records<int32_t>(path).empty());
+    EXPECT_EQ(stats.runs, 0u);
+    std::remove(path.c_str());
+}
+
+TEST(ExternalSortTest, ThrowsOnBadInput)
+{
+    WorkStealingPool pool(1);
+    std::string output = test_path("external_bad.out");
+    ASSERT_THROW(external_sort<int64_t>(pool, test_path("missing.in"), output, std::less<int64_t>()),
+                 std::runtime_error);
+
+    // 20 bytes is not a whole number of 8-byte records
+    std::string input = test_path("external_truncated.in");
+    {
+        std::ofstream out(input, std::ios::binary);
+        out << "twenty bytes of data";
+    }
+    ExternalSortOptions options;
+    options.memory_budget = 64;
+    options.temp_directory = run_directory("external_bad_runs");
+    ASSERT_THROW(external_sort<int64_t>(pool, input, output, std::less<int64_t>(), options), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::is_empty(options.temp_directory));
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST(ExternalSortTest, LoserTreeMergesStably)
+{
+    // Three sources with heads 4, 2 and 2; the tie goes to source 1
+    std::vector<int> heads{4, 2, 2};
+    LoserTree<int, std::less<int>> tree({&heads[0], &heads[1], &heads[2]}, std::less<int>());
+    std::vector<size_t> order;
+    while (!tree.exhausted())
+    {
+        order.push_back(tree.winner());
+        tree.replace_winner(nullptr);
+    }
+    EXPECT_EQ(order, (std::vector<size_t>{1, 2, 0}));
+
+    LoserTree<int, std::less<int>> empty({}, std::less<int>());
+    EXPECT_TRUE(empty.exhausted());
+}
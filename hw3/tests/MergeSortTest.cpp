@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "MergeSort.cpp"
+#include <memory>
+#include <random>
+#include <utility>
+
+// Key and original position; sorting compares keys only, so a stable sort
+// must leave equal keys in position order
+using Tagged = std::pair<int, size_t>;
+
+static bool key_less(const Tagged &a, const Tagged &b)
+{
+    return a.first < b.first;
+}
+
+enum class Pattern
+{
+    Random,
+    FewKeys,
+    Sorted,
+    Reversed,
+    NearlySorted,
+    Sawtooth
+};
+
+static std::vector<Tagged> make_tagged(Pattern pattern, size_t n, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<Tagged> values(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        int key = 0;
+        switch (pattern)
+        {
+        case Pattern::Random:
+            key = static_cast<int>(rng() % (n + 1));
+            break;
+        case Pattern::FewKeys:
+            key = static_cast<int>(rng() % 4);
+            break;
+        case Pattern::Sorted:
+            key = static_cast<int>(i / 3);
+            break;
+        case Pattern::Reversed:
+            key = static_cast<int>((n - i) / 3);
+            break;
+        case Pattern::NearlySorted:
+            key = static_cast<int>(i);
+            break;
+        case Pattern::Sawtooth:
+            key = static_cast<int>(i % 1000);
+            break;
+        }
+        values[i] = {key, i};
+    }
+    if (pattern == Pattern::NearlySorted)
+    {
+        for (size_t k = 0; n > 1 && k < n / 100 + 1; k++)
+            std::swap(values[rng() % n].first, values[rng() % n].first);
+    }
+    return values;
+}
+
+static const Pattern PATTERNS[] = {Pattern::Random, Pattern::FewKeys, Pattern::Sorted,
+                                   Pattern::Reversed, Pattern::NearlySorted, Pattern::Sawtooth};
+
+TEST(MergeSortTest, IsStableOnEveryPattern)
+{
+    for (Pattern pattern : PATTERNS)
+    {
+        for (size_t n : {0, 1, 2, 31, 64, 65, 1000, 20000})
+        {
+            std::vector<Tagged> values = make_tagged(pattern, n, n);
+            std::vector<Tagged> expected = values;
+            std::stable_sort(expected.begin(), expected.end(), key_less);
+            merge_sort(values.begin(), values.end(), key_less);
+            ASSERT_EQ(values, expected) << "pattern " << static_cast<int>(pattern) << ", n = " << n;
+        }
+    }
+}
+
+TEST(MergeSortTest, SortsPresortedInputInLinearComparisons)
+{
+    const size_t n = 100000;
+    size_t comparisons = 0;
+    auto counting_less = [&comparisons](int a, int b)
+    {
+        comparisons++;
+        return a < b;
+    };
+
+    std::vector<int> ascending(n);
+    for (size_t i = 0; i < n; i++)
+        ascending[i] = static_cast<int>(i);
+    merge_sort(ascending.begin(), ascending.end(), counting_less);
+    EXPECT_LT(comparisons, n);
+
+    // Descending input is one run, reversed in place
+    comparisons = 0;
+    std::vector<int> descending(ascending.rbegin(), ascending.rend());
+    merge_sort(descending.begin(), descending.end(), counting_less);
+    EXPECT_EQ(descending, ascending);
+    EXPECT_LT(comparisons, n);
+
+    // A few sorted runs concatenated cost little more than merging them
+    comparisons = 0;
+    std::vector<int> runs;
+    for (int run = 0; run < 4; run++)
+    {
+        for (size_t i = 0; i < n / 4; i++)
+            runs.push_back(static_cast<int>(i * 4 + run));
+    }
+    merge_sort(runs.begin(), runs.end(), counting_less);
+    EXPECT_EQ(runs, ascending);
+    EXPECT_LT(comparisons, 4 * n);
+}
+
+TEST(MergeSortTest, BoundedBufferStaysStable)
+{
+    for (size_t limit : {0, 1, 16, 1000})
+    {
+        for (Pattern pattern : PATTERNS)
+        {
+            std::vector<Tagged> values = make_tagged(pattern, 5000, limit);
+            std::vector<Tagged> expected = values;
+            std::stable_sort(expected.begin(), expected.end(), key_less);
+            merge_sort(values.begin(), values.end(), key_less, limit);
+            ASSERT_EQ(values, expected) << "limit = " << limit << ", pattern " << static_cast<int>(pattern);
+        }
+    }
+}
+
+TEST(MergeSortTest, ParallelSortIsStable)
+{
+    WorkStealingPool pool(4);
+    for (Pattern pattern : PATTERNS)
+    {
+        for (size_t n : {1000, 100000, 300001})
+        {
+            std::vector<Tagged> values = make_tagged(pattern, n, n);
+            std::vector<Tagged> expected = values;
+            std::stable_sort(expected.begin(), expected.end(), key_less);
+            merge_sort(pool, values.begin(), values.end(), key_less);
+            ASSERT_EQ(values, expected) << "pattern " << static_cast<int>(pattern) << ", n = " << n;
+        }
+    }
+}
+
+TEST(MergeSortTest, SortsMoveOnlyElements)
+{
+    auto deref_less = [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b)
+    { return *a < *b; };
+
+    WorkStealingPool pool(2);
+    for (size_t n : {100, 100000})
+    {
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<std::unique_ptr<int>> sequential;
+        std::vector<std::unique_ptr<int>> parallel;
+        std::vector<std::unique_ptr<int>> bounded;
+        for (size_t i = 0; i < n; i++)
+        {
+            int value = static_cast<int>(rng() % 1000);
+            sequential.push_back(std::make_unique<int>(value));
+            parallel.push_back(std::make_unique<int>(value));
+            bounded.push_back(std::make_unique<int>(value));
+        }
+        merge_sort(sequential.begin(), sequential.end(), deref_less);
+        merge_sort(pool, parallel.begin(), parallel.end(), deref_less);
+        merge_sort(bounded.begin(), bounded.end(), deref_less, 8);
+        for (size_t i = 0; i < n; i++)
+        {
+            ASSERT_TRUE(sequential[i] && parallel[i] && bounded[i]);
+            ASSERT_EQ(*parallel[i], *sequential[i]);
+            ASSERT_EQ(*bounded[i], *sequential[i]);
+            if (i > 0)
+            {
+                ASSERT_LE(*sequential[i - 1], *sequential[i]);
+            }
+        }
+    }
+}
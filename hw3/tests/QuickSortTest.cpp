@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "qsort.cpp"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
 
 // Test case: Sorting an empty vector
 TEST(QuickSortTest, SortWithGreater)
@@ -112,3 +117,292 @@ TEST(QuickSortTest, SortReverseSortedVector)
     std::vector<int> expected{1, 2, 3, 4, 5};
     ASSERT_EQ(v, expected);
 }
+
+// Inputs that break naive quicksorts: presorted, reversed, organ-pipe, all-equal, few distinct
+static std::vector<std::vector<int>> adversarial_inputs(int n)
+{
+    std::vector<std::vector<int>> inputs(6, std::vector<int>(n));
+    std::mt19937 rng(17);
+    for (int i = 0; i < n; i++)
+    {
+        inputs[0][i] = i;
+        inputs[1][i] = n - i;
+        inputs[2][i] = i < n / 2 ? i : n - i;
+        inputs[3][i] = 7;
+        inputs[4][i] = static_cast<int>(rng() % 4);
+        inputs[5][i] = static_cast<int>(rng());
+    }
+    return inputs;
+}
+
+TEST(QuickSortTest, SortAdversarialPatterns)
+{
+    for (int n : {0, 2, 23, 24, 25, 129, 1000, 100000})
+    {
+        for (std::vector<int> v : adversarial_inputs(n))
+        {
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end());
+            quick_sort(v.begin(), v.end(), std::less<int>());
+            ASSERT_EQ(v, expected) << "n = " << n;
+        }
+    }
+}
+
+TEST(QuickSortTest, ComparisonsStayNearNLogN)
+{
+    // Every pattern must stay within a constant factor of n log2 n comparisons
+    const int n = 1 << 16;
+    for (std::vector<int> v : adversarial_inputs(n))
+    {
+        size_t comparisons = 0;
+        quick_sort(v.begin(), v.end(), [&](int a, int b)
+                   {
+            comparisons++;
+            return a < b; });
+        ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+        ASSERT_LT(comparisons, 4u * n * 16);
+    }
+}
+
+TEST(QuickSortTest, SurvivesMcIlroyAdversary)
+{
+    // McIlroy's "killer adversary" decides element values lazily so that every
+    // pivot comes out as bad as possible; the heapsort fallback must still
+    // keep the comparison count O(n log n)
+    const int n = 1 << 14;
+    const int gas = n;
+    std::vector<int> values(n, gas);
+    std::vector<int> items(n);
+    for (int i = 0; i < n; i++)
+        items[i] = i;
+
+    int solid = 0;
+    int candidate = 0;
+    size_t comparisons = 0;
+    auto adversary = [&](int x, int y)
+    {
+        comparisons++;
+        if (values[x] == gas && values[y] == gas)
+            values[x == candidate ? x : y] = solid++;
+        if (values[x] == gas)
+            candidate = x;
+        else if (values[y] == gas)
+            candidate = y;
+        return values[x] < values[y];
+    };
+
+    quick_sort(items.begin(), items.end(), adversary);
+    for (int i = 1; i < n; i++)
+        ASSERT_LE(values[items[i - 1]], values[items[i]]);
+    ASSERT_LT(comparisons, 6u * n * 14);
+}
+
+TEST(QuickSortTest, ThreeWayPartitionSortsAllPatterns)
+{
+    for (int n : {0, 2, 25, 1000, 100000})
+    {
+        for (std::vector<int> v : adversarial_inputs(n))
+        {
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+            quick_sort(v.begin(), v.end(), std::greater<int>(), PartitionScheme::ThreeWay);
+            ASSERT_EQ(v, expected) << "n = " << n;
+        }
+    }
+}
+
+TEST(QuickSortTest, ThreeWayPartitionIsLinearOnFewDistinctKeys)
+{
+    const int n = 1 << 16;
+    for (int distinct : {1, 4, 16})
+    {
+        std::vector<int> v(n);
+        for (int i = 0; i < n; i++)
+            v[i] = (i * 7919) % distinct;
+
+        size_t comparisons = 0;
+        quick_sort(v.begin(), v.end(), [&](int a, int b)
+                   {
+            comparisons++;
+            return a < b; }, PartitionScheme::ThreeWay);
+        ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+        // About two comparisons per element for each of the ~log2(distinct) levels
+        ASSERT_LT(comparisons, 3u * n * (1 + std::log2(distinct)));
+    }
+}
+
+TEST(QuickSortTest, SeededRunsAreReproducible)
+{
+    // Organ-pipe input makes bad partitions, so the random pattern breaking runs
+    auto count_comparisons = [](uint64_t seed)
+    {
+        std::vector<int> v = adversarial_inputs(50000)[2];
+        size_t comparisons = 0;
+        seed_quick_sort(seed);
+        quick_sort(v.begin(), v.end(), [&](int a, int b)
+                   {
+            comparisons++;
+            return a < b; });
+        return comparisons;
+    };
+
+    ASSERT_EQ(count_comparisons(5), count_comparisons(5));
+    ASSERT_NE(count_comparisons(5), count_comparisons(6));
+}
+
+TEST(QuickSortTest, SortRandomBelowIsInRangeAndUnbiased)
+{
+    SortRandom random(1);
+    std::vector<int> counts(3);
+    for (int i = 0; i < 30000; i++)
+    {
+        uint64_t value = random.below(3);
+        ASSERT_LT(value, 3u);
+        counts[value]++;
+    }
+    for (int count : counts)
+        ASSERT_NEAR(count, 10000, 500);
+}
+
+TEST(QuickSortTest, ConcurrentSortsOnSeparateThreads)
+{
+    std::vector<std::vector<int>> inputs = adversarial_inputs(200000);
+    std::vector<std::thread> threads;
+    for (std::vector<int> &v : inputs)
+        threads.emplace_back([&v]()
+                             { quick_sort(v.begin(), v.end(), std::less<int>()); });
+    for (std::thread &thread : threads)
+        thread.join();
+    for (const std::vector<int> &v : inputs)
+        ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+}
+
+TEST(QuickSortTest, ParallelSortsAllPatterns)
+{
+    WorkStealingPool pool(4);
+    for (int n : {0, 1, 25, 1000, 100000, (1 << 20) + 3})
+    {
+        for (PartitionScheme scheme : {PartitionScheme::Hoare, PartitionScheme::ThreeWay})
+        {
+            for (std::vector<int> v : adversarial_inputs(n))
+            {
+                std::vector<int> expected = v;
+                std::sort(expected.begin(), expected.end());
+                quick_sort(pool, v.begin(), v.end(), std::less<int>(), scheme);
+                ASSERT_EQ(v, expected) << "n = " << n;
+            }
+        }
+    }
+}
+
+TEST(QuickSortTest, ParallelSortWithGreaterAndStrings)
+{
+    WorkStealingPool pool(3);
+    std::mt19937 rng(5);
+    std::vector<std::string> v(200000);
+    for (std::string &s : v)
+        s = std::to_string(rng() % 50000);
+    std::vector<std::string> expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<std::string>());
+
+    quick_sort(pool, v.begin(), v.end(), std::greater<std::string>());
+    ASSERT_EQ(v, expected);
+}
+
+TEST(QuickSortTest, ParallelSortRethrowsComparatorException)
+{
+    WorkStealingPool pool(2);
+    std::vector<int> v = adversarial_inputs(100000)[5];
+    auto throwing = [](int a, int b)
+    {
+        if (a == b)
+            throw std::runtime_error("equal keys");
+        return a < b;
+    };
+    v.push_back(v.front());
+    ASSERT_THROW(quick_sort(pool, v.begin(), v.end(), throwing), std::runtime_error);
+}
+
+TEST(QuickSortTest, PartitionBlocksSplitsEverySize)
+{
+    std::mt19937 rng(3);
+    for (int n = 0; n <= 600; n++)
+    {
+        for (int threshold : {0, 3, 50, 100})
+        {
+            std::vector<int> v(n);
+            for (int &x : v)
+                x = static_cast<int>(rng() % 100);
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end());
+
+            auto split = partition_blocks(v.begin(), v.end(), [threshold](int x)
+                                          { return x < threshold; });
+            ASSERT_TRUE(std::all_of(v.begin(), split, [threshold](int x)
+                                    { return x < threshold; }));
+            ASSERT_TRUE(std::none_of(split, v.end(), [threshold](int x)
+                                     { return x < threshold; }));
+            std::sort(v.begin(), v.end());
+            ASSERT_EQ(v, expected) << "n = " << n;
+        }
+    }
+}
+
+TEST(QuickSortTest, BlockPartitionSortsAllPatterns)
+{
+    for (int n : {0, 2, 23, 25, 129, 1000, 100000})
+    {
+        for (std::vector<int> v : adversarial_inputs(n))
+        {
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end());
+            // A lambda keeps the ints off the vectorized path
+            quick_sort(v.begin(), v.end(), [](int a, int b)
+                       { return a < b; }, PartitionScheme::Block);
+            ASSERT_EQ(v, expected) << "n = " << n;
+        }
+    }
+}
+
+TEST(QuickSortTest, BlockPartitionSortsStringsAndPairs)
+{
+    std::mt19937 rng(11);
+    std::vector<std::string> strings(50000);
+    std::vector<std::pair<int, std::string>> pairs(50000);
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+        strings[i] = std::to_string(rng() % 100000);
+        pairs[i] = {static_cast<int>(rng() % 50), strings[i]};
+    }
+
+    std::vector<std::string> expected_strings = strings;
+    std::sort(expected_strings.begin(), expected_strings.end(), std::greater<std::string>());
+    quick_sort(strings.begin(), strings.end(), std::greater<std::string>(), PartitionScheme::Block);
+    ASSERT_EQ(strings, expected_strings);
+
+    std::vector<std::pair<int, std::string>> expected_pairs = pairs;
+    std::sort(expected_pairs.begin(), expected_pairs.end());
+    quick_sort(pairs.begin(), pairs.end(), std::less<std::pair<int, std::string>>(), PartitionScheme::Block);
+    ASSERT_EQ(pairs, expected_pairs);
+
+    WorkStealingPool pool(2);
+    std::shuffle(pairs.begin(), pairs.end(), rng);
+    quick_sort(pool, pairs.begin(), pairs.end(), std::less<std::pair<int, std::string>>(), PartitionScheme::Block);
+    ASSERT_EQ(pairs, expected_pairs);
+}
+
+TEST(QuickSortTest, BlockPartitionComparisonsStayNearNLogN)
+{
+    const int n = 1 << 16;
+    for (std::vector<int> v : adversarial_inputs(n))
+    {
+        size_t comparisons = 0;
+        quick_sort(v.begin(), v.end(), [&](int a, int b)
+                   {
+            comparisons++;
+            return a < b; }, PartitionScheme::Block);
+        ASSERT_TRUE(std::is_sorted(v.begin(), v.end()));
+        ASSERT_LT(comparisons, 4u * n * 16);
+    }
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "RadixSort.cpp"
+#include <limits>
+#include <memory>
+#include <random>
+
+template <typename T>
+static std::vector<T> random_values(size_t n, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<T> values(n);
+    for (T &value : values)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            value = static_cast<T>(static_cast<int64_t>(rng())) / 1e6;
+        else
+            value = static_cast<T>(rng());
+    }
+    return values;
+}
+
+template <typename T>
+static void check_radix_sort()
+{
+    for (size_t n : {0, 1, 2, 100, 5000})
+    {
+        std::vector<T> values = random_values<T>(n, n);
+        std::vector<T> expected = values;
+        std::sort(expected.begin(), expected.end());
+        radix_sort(values.begin(), values.end());
+        ASSERT_EQ(values, expected) << "n = " << n;
+    }
+}
+
+TEST(RadixSortTest, SortsEveryIntegerWidth)
+{
+    check_radix_sort<int8_t>();
+    check_radix_sort<uint8_t>();
+    check_radix_sort<int16_t>();
+    check_radix_sort<uint16_t>();
+    check_radix_sort<int32_t>();
+    check_radix_sort<uint32_t>();
+    check_radix_sort<int64_t>();
+    check_radix_sort<uint64_t>();
+}
+
+TEST(RadixSortTest, SortsFloatingPointIncludingExtremes)
+{
+    check_radix_sort<float>();
+    check_radix_sort<double>();
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> values{3.5, -inf, 0.0, -1e-300, inf, -2.25, 1e300, std::numeric_limits<double>::denorm_min(),
+                               -0.5, std::numeric_limits<double>::lowest()};
+    std::vector<double> expected = values;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(values.begin(), values.end());
+    ASSERT_EQ(values, expected);
+}
+
+TEST(RadixSortTest, SortsRangesWithOneDistinctByte)
+{
+    // Only the low byte varies, so all passes but one are skipped
+    std::vector<uint64_t> values;
+    for (uint64_t i = 0; i < 1000; i++)
+        values.push_back(0x1234567800000000ULL + (i * 37) % 256);
+    std::vector<uint64_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(values.begin(), values.end());
+    ASSERT_EQ(values, expected);
+
+    std::vector<int> same(500, -7);
+    radix_sort(same.begin(), same.end());
+    ASSERT_EQ(same, std::vector<int>(500, -7));
+}
+
+TEST(RadixSortTest, KeyOfSortIsStable)
+{
+    std::mt19937 rng(8);
+    std::vector<std::pair<int, int>> records(20000);
+    for (int i = 0; i < 20000; i++)
+        records[i] = {static_cast<int>(rng() % 100) - 50, i};
+
+    radix_sort(records.begin(), records.end(), [](const std::pair<int, int> &record)
+               { return record.first; });
+    for (size_t i = 1; i < records.size(); i++)
+    {
+        ASSERT_LE(records[i - 1].first, records[i].first);
+        if (records[i - 1].first == records[i].first)
+        {
+            ASSERT_LT(records[i - 1].second, records[i].second);
+        }
+    }
+}
+
+TEST(RadixSortTest, KeyOfSortMovesOnlyElements)
+{
+    // Neither copyable nor default-constructible
+    struct Item
+    {
+        std::unique_ptr<int> value;
+        explicit Item(int v) : value(std::make_unique<int>(v)) {}
+    };
+
+    std::vector<Item> items;
+    std::mt19937 rng(4);
+    for (int i = 0; i < 3000; i++)
+        items.emplace_back(static_cast<int>(rng() % 100000));
+
+    radix_sort(items.begin(), items.end(), [](const Item &item)
+               { return *item.value; });
+    for (size_t i = 1; i < items.size(); i++)
+        ASSERT_LE(*items[i - 1].value, *items[i].value);
+}
+
+TEST(RadixSortTest, SortsStringsInStdStringOrder)
+{
+    std::mt19937 rng(12);
+    std::vector<std::string> strings;
+    for (int i = 0; i < 20000; i++)
+    {
+        // Shared prefixes, prefixes of each other, empty strings and bytes above 0x7F
+        std::string s = i % 3 == 0 ? "common/prefix/" : "";
+        size_t length = rng() % 6;
+        for (size_t j = 0; j < length; j++)
+            s.push_back(static_cast<char>(rng() % 4 == 0 ? 0xC3 : 'a' + rng() % 3));
+        strings.push_back(s);
+    }
+
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(strings.begin(), strings.end());
+    ASSERT_EQ(strings, expected);
+
+    std::vector<std::string_view> views(expected.rbegin(), expected.rend());
+    radix_sort(views.begin(), views.end());
+    ASSERT_TRUE(std::equal(views.begin(), views.end(), expected.begin(), expected.end()));
+}
+
+TEST(RadixSortTest, SortsLongSharedPrefixes)
+{
+    std::vector<std::string> strings;
+    for (int i = 0; i < 2000; i++)
+        strings.push_back(std::string(5000, 'x') + std::to_string(i * 7919 % 2000));
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(strings.begin(), strings.end());
+    ASSERT_EQ(strings, expected);
+}
+
+TEST(RadixSortTest, DispatchSortMatchesStdSortBothWays)
+{
+    for (size_t n : {10, 300, 5000, 70000})
+    {
+        std::vector<int64_t> longs = random_values<int64_t>(n, n);
+        std::vector<int64_t> expected_longs = longs;
+        std::sort(expected_longs.begin(), expected_longs.end(), std::greater<int64_t>());
+        dispatch_sort(longs.begin(), longs.end(), std::greater<int64_t>());
+        ASSERT_EQ(longs, expected_longs);
+
+        std::vector<float> floats = random_values<float>(n, n + 1);
+        std::vector<float> expected_floats = floats;
+        std::sort(expected_floats.begin(), expected_floats.end());
+        dispatch_sort(floats.begin(), floats.end(), std::less<>());
+        ASSERT_EQ(floats, expected_floats);
+
+        std::vector<std::string> strings(n);
+        for (size_t i = 0; i < n; i++)
+            strings[i] = std::to_string(longs[i] % 1000);
+        std::vector<std::string> expected_strings = strings;
+        std::sort(expected_strings.begin(), expected_strings.end(), std::greater<std::string>());
+        dispatch_sort(strings.begin(), strings.end(), std::greater<std::string>());
+        ASSERT_EQ(strings, expected_strings);
+
+        // Comparators radix sort cannot honor go to quick_sort
+        std::vector<int64_t> by_magnitude = random_values<int64_t>(n, n + 2);
+        auto magnitude = [](int64_t a, int64_t b)
+        { return (a < 0 ? -(a + 1) : a) < (b < 0 ? -(b + 1) : b); };
+        dispatch_sort(by_magnitude.begin(), by_magnitude.end(), magnitude);
+        ASSERT_TRUE(std::is_sorted(by_magnitude.begin(), by_magnitude.end(), magnitude));
+    }
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "qsort.cpp"
+#include <deque>
+#include <random>
+
+// random_keys() - n keys drawn from `distinct` values, so duplicates are common for small ones
+template <typename T>
+static std::vector<T> random_keys(size_t n, uint64_t distinct, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<T> keys(n);
+    for (T &key : keys)
+    {
+        uint64_t draw = rng() % distinct;
+        if constexpr (std::is_floating_point_v<T>)
+            key = static_cast<T>(static_cast<int64_t>(draw) - static_cast<int64_t>(distinct / 2)) / 4;
+        else if constexpr (std::is_signed_v<T>)
+            key = static_cast<T>(static_cast<int64_t>(draw) - static_cast<int64_t>(distinct / 2));
+        else
+            key = static_cast<T>(draw) * (std::numeric_limits<T>::max() / distinct);
+    }
+    return keys;
+}
+
+// check_partition() - Runs kernel on keys and checks the split and that no key was lost
+template <typename T, bool Descending, bool OrEqual>
+static void check_partition(SimdPartitionFn<T> kernel, std::vector<T> keys, T pivot)
+{
+    std::vector<T> before = keys;
+    T *split = kernel(keys.data(), keys.data() + keys.size(), pivot);
+    for (T *key = keys.data(); key != keys.data() + keys.size(); ++key)
+        ASSERT_EQ((selects<T, Descending, OrEqual>(*key, pivot)), key < split) << "size " << keys.size();
+
+    std::sort(before.begin(), before.end());
+    std::sort(keys.begin(), keys.end());
+    ASSERT_EQ(before, keys);
+}
+
+template <typename T, bool Descending>
+static void check_kernels(const SimdSortKernels<T, Descending> &kernels)
+{
+    for (size_t n : {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, 4099})
+    {
+        for (uint64_t distinct : {1, 3, 1000})
+        {
+            std::vector<T> keys = random_keys<T>(n, distinct, n + distinct);
+            T pivot = keys.empty() ? T() : keys[keys.size() / 2];
+            check_partition<T, Descending, false>(kernels.before, keys, pivot);
+            check_partition<T, Descending, true>(kernels.not_after, keys, pivot);
+        }
+    }
+    if (kernels.small_sort == nullptr)
+        return;
+
+    for (ptrdiff_t n = 0; n <= kernels.small_sort_max; n++)
+    {
+        std::vector<T> keys = random_keys<T>(n, 20, n);
+        std::vector<T> expected = keys;
+        if (Descending)
+            std::sort(expected.begin(), expected.end(), std::greater<T>());
+        else
+            std::sort(expected.begin(), expected.end());
+
+        kernels.small_sort(keys.data(), keys.data() + n);
+        ASSERT_EQ(keys, expected) << "size " << n;
+    }
+}
+
+template <typename T>
+static void check_all_kernels()
+{
+#if SIMD_PARTITION_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        check_kernels<T, false>({partition_avx2<T, false, false>, partition_avx2<T, false, true>,
+                                 network_sort_avx2<T, false>, 2 * 32 / sizeof(T)});
+        check_kernels<T, true>({partition_avx2<T, true, false>, partition_avx2<T, true, true>,
+                                network_sort_avx2<T, true>, 2 * 32 / sizeof(T)});
+    }
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        check_kernels<T, false>({partition_avx512<T, false, false>, partition_avx512<T, false, true>,
+                                 network_sort_avx512<T, false>, 2 * 64 / sizeof(T)});
+        check_kernels<T, true>({partition_avx512<T, true, false>, partition_avx512<T, true, true>,
+                                network_sort_avx512<T, true>, 2 * 64 / sizeof(T)});
+    }
+#endif
+    check_kernels<T, false>({partition_scalar<T, false, false>, partition_scalar<T, false, true>, nullptr, 0});
+}
+
+TEST(SimdPartitionTest, KernelsPartitionAndSortEveryKeyType)
+{
+    check_all_kernels<int32_t>();
+    check_all_kernels<float>();
+    check_all_kernels<double>();
+    check_all_kernels<uint64_t>();
+}
+
+TEST(SimdPartitionTest, DetectsSortableRanges)
+{
+    ASSERT_TRUE((SimdSortable<std::vector<int>::iterator, std::less<int>>::value == SIMD_PARTITION_X86));
+    ASSERT_TRUE((SimdSortable<float *, std::greater<>>::value == SIMD_PARTITION_X86));
+    ASSERT_FALSE((SimdSortable<std::vector<int>::iterator, std::function<bool(int, int)>>::value));
+    ASSERT_FALSE((SimdSortable<std::vector<short>::iterator, std::less<short>>::value));
+    ASSERT_FALSE((SimdSortable<std::deque<int>::iterator, std::less<int>>::value));
+}
+
+template <typename T>
+static void check_quick_sort()
+{
+    for (size_t n : {0, 5, 33, 1000, 100000})
+    {
+        for (uint64_t distinct : {1, 4, 1000000})
+        {
+            for (PartitionScheme scheme : {PartitionScheme::Hoare, PartitionScheme::ThreeWay})
+            {
+                std::vector<T> keys = random_keys<T>(n, distinct, n * distinct);
+                std::vector<T> expected = keys;
+
+                std::sort(expected.begin(), expected.end());
+                quick_sort(keys.begin(), keys.end(), std::less<T>(), scheme);
+                ASSERT_EQ(keys, expected);
+
+                // Sorting the sorted keys the other way round is the reversed-input pattern
+                std::reverse(expected.begin(), expected.end());
+                quick_sort(keys.data(), keys.data() + n, std::greater<>(), scheme);
+                ASSERT_EQ(keys, expected);
+            }
+        }
+    }
+}
+
+TEST(SimdPartitionTest, QuickSortsEveryKeyTypeBothWays)
+{
+    check_quick_sort<int32_t>();
+    check_quick_sort<float>();
+    check_quick_sort<double>();
+    check_quick_sort<uint64_t>();
+}
+
+TEST(SimdPartitionTest, ParallelQuickSortUsesTheKernels)
+{
+    WorkStealingPool pool(2);
+    std::vector<float> keys = random_keys<float>(300000, 5000, 9);
+    std::vector<float> expected = keys;
+    std::sort(expected.begin(), expected.end(), std::greater<float>());
+
+    quick_sort(pool, keys.begin(), keys.end(), std::greater<float>());
+    ASSERT_EQ(keys, expected);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.cpp"
+#include <stdexcept>
+
+TEST(ThreadPoolTest, RunsEveryTask)
+{
+    WorkStealingPool pool(4);
+    std::atomic<int> count(0);
+    TaskGroup group(pool);
+    for (int i = 0; i < 1000; i++)
+        group.run([&count]()
+                  { count++; });
+    group.wait();
+    ASSERT_EQ(count.load(), 1000);
+}
+
+// fib() - Forks one call per level, so waits nest as deep as the recursion
+static long fib(WorkStealingPool &pool, int n)
+{
+    if (n < 2)
+        return n;
+    long left = 0;
+    TaskGroup group(pool);
+    group.run([&]()
+              { left = fib(pool, n - 1); });
+    long right = fib(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+TEST(ThreadPoolTest, NestedGroupsDoNotDeadlock)
+{
+    WorkStealingPool pool(2);
+    ASSERT_EQ(fib(pool, 20), 6765);
+}
+
+TEST(ThreadPoolTest, WaitRethrowsFirstException)
+{
+    WorkStealingPool pool(3);
+    TaskGroup group(pool);
+    for (int i = 0; i < 10; i++)
+        group.run([]()
+                  { throw std::logic_error("task failed"); });
+    ASSERT_THROW(group.wait(), std::logic_error);
+
+    // The group is reusable once the error has been reported
+    bool ran = false;
+    group.run([&ran]()
+              { ran = true; });
+    group.wait();
+    ASSERT_TRUE(ran);
+}
+
+TEST(ThreadPoolTest, DefaultSizeUsesHardwareThreads)
+{
+    WorkStealingPool pool;
+    ASSERT_GE(pool.size(), 1u);
+}